@@ -0,0 +1,88 @@
+/*
+ * example blinks multiple outputs with scheduler in one thread
+ *
+ * connect leds to gpio pins 20 and 21 with resistors (220-470 Ohm) and common to ground 
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./blink_sched
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "../include/gpiox.h"
+#include "../include/c_timer.h"
+
+#define OUTPUT_PIN1 21
+#define OUTPUT_PIN2 20
+
+#define BLINK_TIME_MS_1 500 // ms
+#define BLINK_TIME_MS_2 1500 // ms
+#define STATS_TIME_MS 10000 // ms
+
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// gpio
+c_gpio gpio1(&chip, PRINT_MSG);
+c_gpio gpio2(&chip, PRINT_MSG);
+
+// scheduler
+c_scheduler scheduler;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+
+    // clear outputs
+    gpio1.write(0);
+    gpio2.write(0);
+
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** scheduler blink C++ example ***");
+    puts("stop program with Ctrl+C");
+
+    // init output 1
+    if (!gpio1.init(OUTPUT_PIN1, GPIO_MODE_OUTPUT))
+        return 1;
+
+    // init output 2
+    if (!gpio2.init(OUTPUT_PIN2, GPIO_MODE_OUTPUT))
+        return 1;
+
+    // add blink tasks
+    int32_t id1 = scheduler.add(BLINK_TIME_MS_1 * 1000000l, []() { gpio1.toggle(); });
+    scheduler.add(BLINK_TIME_MS_2 * 1000000l, []() { gpio2.toggle(); });
+
+    // add task prints statistics of blink task 1
+    scheduler.add(STATS_TIME_MS * 1000000l, [id1]()
+    {
+        timer_stats stats;
+
+        if (scheduler.get_stats(id1, stats) && (stats.count > 0))
+            printf("jitter min: %lld us, max: %lld us, mean: %lld us, overruns: %llu\n",
+                (long long) stats.jitter_min / 1000,
+                (long long) stats.jitter_max / 1000,
+                (long long) (stats.jitter_sum / stats.count) / 1000,
+                (unsigned long long) stats.overruns);
+    }, STATS_TIME_MS * 1000000l);
+
+    // run tasks in this thread
+    scheduler.run();
+
+    return 0;
+}
@@ -53,7 +53,7 @@ public:
     c_blink(c_gpio* gpio, int32_t period)
     {
         m_gpio = gpio;
-        m_period = period;
+        m_period.set_period(period * 1000000l);
     }
 
     ~c_blink() {}
@@ -61,11 +61,14 @@ public:
     // execute thread 
     void Execute() override
     {
+        // start period
+        m_period.start();
+
         // blink output
         while(1)
         {
-            // sleep
-            m_timer.sleep_ms(m_period);
+            // sleep until next period, no drift
+            m_period.wait();
 
             // toggle output
             m_gpio->toggle();
@@ -73,9 +76,8 @@ public:
     }
 
 private:
-    int32_t m_period;
     c_gpio* m_gpio;
-    c_timer m_timer;
+    c_periodic m_period;
 };
 
 int main()
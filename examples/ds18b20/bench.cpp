@@ -0,0 +1,109 @@
+/*
+ * example measures bus time per sensor of ds18b20 read modes
+ *
+ * connect ds18b20 data pin to gpio pin 21
+ * connect pullup resistor between pin 21 and +3.3v    
+ * skip rom mode needs single sensor on bus
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./bench
+ *
+ */
+
+#include <stdio.h>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_PIN 21 // gpio pin for ds18b20
+#define SENSOR_RES RES_SENSOR_9 // sensor resolution
+#define PRINT_MSG true // print error on console
+#define NLOOP 20 // reads of each mode
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver
+c_ds18b20 ds18b20;
+
+// idlist
+vector<sensor_id> idlist;
+
+// read modes
+struct {
+    uint32_t mode;
+    const char* name;
+} modes[] = {
+    { READ_MODE_FULL, "match rom, 9 bytes, crc" },
+    { READ_MODE_SKIP_ROM, "skip rom, 9 bytes, crc" },
+    { READ_MODE_NO_CRC, "match rom, 2 bytes" },
+    { READ_MODE_SKIP_ROM | READ_MODE_NO_CRC, "skip rom, 2 bytes" },
+};
+
+int main()
+{
+    puts("*** ds18b20 read mode benchmark C++ example ***");
+
+    // create timer
+    c_timer timer;
+
+    // init ds18b20
+    if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
+        return 1;
+    
+    // scan for sensors on 1-wire bus
+    if (!ds18b20.scan_sensor(idlist))
+        return 1;
+
+    if (idlist.size() == 0)
+    {
+        puts("no sensor on bus");
+        return 1;
+    }
+
+    printf("%d sensor(s) on bus\n", (int) idlist.size());
+
+    // set sensor resolution
+    if (!ds18b20.set_resolution(SENSOR_RES))
+        return 1;
+
+    // temperatures stay in pad after conversion
+    vector<double> templist;
+
+    if (!ds18b20.read_sensors(idlist, false, templist))
+        return 1;
+
+    for (auto& m: modes)
+    {
+        ds18b20.set_read_mode(m.mode);
+
+        uint64_t bits = ds18b20.bus().get_bits();
+        uint32_t nread = 0;
+
+        int64_t start = timer.now();
+
+        // read pads without conversion
+        for (uint32_t i = 0; i < NLOOP; i++)
+        {
+            if (!ds18b20.collect(idlist, false, templist))
+                return 1;
+
+            for (double temp: templist)
+                if (temp != INV_TEMP)
+                    nread++;
+        }
+
+        double nsensor = double(NLOOP) * idlist.size();
+        double ms = double(timer.now() - start) / 1e6;
+
+        printf("%-24s %.2fms/sensor %.0f bits/sensor %d%% read\n",
+            m.name,
+            ms / nsensor,
+            double(ds18b20.bus().get_bits() - bits) / nsensor,
+            int(100.0 * nread / nsensor));
+    }
+
+    return 0;
+}
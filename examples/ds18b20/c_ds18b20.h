@@ -12,11 +12,21 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <future>
+#include <functional>
+#include <map>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
 using namespace std;
 
-#include "../../include/gpiox.h"
-#include "../../include/c_timer.h"
-#include "../../include/c_priority.h"
+#include <math.h>
+
+#include "../../include/c_onewire.h"
+#include "../../include/c_queue.h"
 
 // mark temp. as invalid
 #define INV_TEMP -9999.0
@@ -30,7 +40,45 @@ enum {
 };
 
 // sensor id (64bit)
-typedef unsigned long long sensor_id;
+typedef ow_id sensor_id;
+
+// sensor read modes, can be combined
+enum {
+    READ_MODE_FULL = 0,     // match rom, 9 byte pad with crc
+    READ_MODE_SKIP_ROM = 1, // skip rom if sensor is single sensor on bus
+    READ_MODE_NO_CRC = 2,   // read only 2 temperature bytes, no crc
+};
+
+// quarantine of failing sensors
+#define QUARANTINE_FAILS 3              // failed reads in sequence until quarantine
+#define QUARANTINE_MIN_NS 1000000000l   // first back-off 1s
+#define QUARANTINE_MAX_NS 300000000000l // max. back-off 5min
+
+/**
+ * @brief health statistics of sensor
+ */
+struct ds18b20_health {
+    uint32_t reads;       // reads of sensor
+    uint32_t valid;       // valid reads
+    uint32_t crc_errors;  // pad reads with crc mismatch
+    uint32_t timeouts;    // pad reads without answer of sensor
+    uint32_t power_on;    // 85°C power-on values, conversion lost
+    uint32_t fails;       // failed reads in sequence
+    uint32_t quarantines; // count of quarantines
+    uint32_t skips;       // reads skipped in quarantine
+    bool quarantined;     // sensor is quarantined
+    int64_t retry_ns;     // time of next probe read (c_timer::now)
+    int64_t backoff_ns;   // actual back-off
+};
+
+// adaptive sampling of fleet scheduler
+#define FLEET_MIN_NS 1000000000l  // min. sample interval 1s
+#define FLEET_MAX_NS 60000000000l // max. sample interval 60s
+#define FLEET_DELTA 0.25          // change of temp. between samples
+
+// back-off of conversion complete polling in ns
+#define POLL_CONVERT_MIN 2000000l // first poll interval
+#define POLL_CONVERT_DIV 16       // max. poll interval is conversion time / div
 
 class c_ds18b20
 {
@@ -41,6 +89,17 @@ public:
     c_ds18b20()
     {
         m_res = RES_SENSOR_12;
+        m_mode = READ_MODE_FULL;
+        m_single = 0ULL;
+        m_poll = false;
+        m_conv_poll = false;
+        m_ready_ns = 0;
+        m_poll_ns = 0;
+        m_poll_interval = 0;
+        m_conv_ns = 0;
+        m_quarantine = true;
+        m_driver = NULL;
+        walk_reset();
     }
 
     /**
@@ -49,7 +108,7 @@ public:
      */
     const char* get_error()
     {
-        return m_gpio.get_error();
+        return m_bus.get_error();
     }
 
     /**
@@ -125,7 +184,7 @@ public:
         id <<= 8;
         id &= ~(0xFFULL);
         id |= (sensor_id) family;
-        id |= ((sensor_id) crc8((uint8_t*) &id, 7)) << 56;
+        id |= ((sensor_id) c_onewire::crc8((uint8_t*) &id, 7)) << 56;
 
         return true;
     }
@@ -154,16 +213,21 @@ public:
      */
     bool init(c_chip* chip, uint32_t pin, bool print_msg = false)
     {
-        m_gpio.setchip(chip, print_msg);
-        
-        // init gpio pin
-        return m_gpio.init(pin, GPIO_MODE_OUTPUT);
+        // init 1-wire bus
+        return m_bus.init(chip, pin, print_msg);
     }
 
+    /**
+     * @brief returns 1-wire bus
+     */
+    c_onewire& bus() { return m_bus; }
+
     /**
      * @brief set resolution on all sensors on bus
      * @param red sensor resolution RES_SENSOR_..
      * @returns false if no sensor on bus or error
+     * @note overwrites alarm window of all sensors with TH 127°C and TL -128°C (never alarm),
+     *       discover() finds new sensors by alarm, set alarm window after with set_config()
      */
     bool set_resolution(uint32_t res)
     {
@@ -172,36 +236,130 @@ public:
         // clear error
         clear_error();
 
-        uint8_t cfg;
-
-        // set parameter depends on on sensor resolution
-        switch(res)
-        {
-        case RES_SENSOR_9:
-            cfg = 0x1f;
-            break;
-        case RES_SENSOR_10:
-            cfg = 0x3f;
-            break;
-        case RES_SENSOR_11:
-            cfg = 0x5f;
-            break;
-        default:
-        case RES_SENSOR_12:
-            cfg = 0x7f;
-            break;
-        }
-    
-        // write resolution to sensors
-        if (!write_pad(cfg))
+        // write resolution to sensors, never alarm
+        if (!write_pad(NULL, res_cfg(res), 127, -128))
         	return false;
     
         m_timer.sleep_ms(1);
         m_res = res;
+
+        // all sensors have same resolution
+        m_sensor_res.clear();
     
         return true;
     }
 
+    /**
+     * @brief set resolution and alarm window of one sensor
+     * @param id 64 bit sensor id
+     * @param res sensor resolution RES_SENSOR_..
+     * @param th alarm high temp. in °C, alarm if temp. >= th
+     * @param tl alarm low temp. in °C, alarm if temp. <= tl
+     * @param store true: copy pad to sensor eeprom, kept on power off,
+     *        false: pad only, lost on power off
+     * @returns false if no sensor with id or error
+     * @note sensors in alarm are found with alarm search (discover)
+     * @note own resolutions need external power, bus is used while other sensors convert
+     * @note eeprom has limited write cycles, store only on change of config
+     */
+    bool set_config(const sensor_id& id, uint32_t res, int8_t th = 127, int8_t tl = -128, bool store = false)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        // write resolution and alarm window to sensor
+        if (!write_pad(&id, res_cfg(res), th, tl))
+            return false;
+
+        // copy pad to eeprom
+        if (store && !copy_pad(&id))
+            return false;
+
+        // own resolution only if differs from bus resolution
+        if ((res & 3) != m_res)
+            m_sensor_res[id] = res & 3;
+        else
+            m_sensor_res.erase(id);
+
+        return true;
+    }
+
+    /**
+     * @brief reads resolution and alarm window of one sensor
+     * @param id 64 bit sensor id
+     * @param res receives sensor resolution RES_SENSOR_..
+     * @param th receives alarm high temp. in °C
+     * @param tl receives alarm low temp. in °C
+     * @param repeat number of reads attemps 1..
+     * @returns false if no sensor with id or error
+     * @note resolution of sensor is used for conversion time
+     */
+    bool get_config(const sensor_id& id, uint32_t& res, int8_t& th, int8_t& tl, uint8_t repeat = 10)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        uint8_t pad[9];
+
+        if (!read_pad(&id, pad, repeat))
+            return false;
+
+        th = (int8_t) pad[2];
+        tl = (int8_t) pad[3];
+        res = (pad[4] >> 5) & 3;
+
+        // own resolution only if differs from bus resolution
+        if (res != m_res)
+            m_sensor_res[id] = res;
+        else
+            m_sensor_res.erase(id);
+
+        return true;
+    }
+
+    /**
+     * @brief returns resolution of sensor
+     * @param id 64 bit sensor id
+     * @returns sensor resolution RES_SENSOR_..
+     */
+    uint32_t get_resolution(const sensor_id& id)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        return res_of(id);
+    }
+
+    /**
+     * @brief returns true if sensors on bus have own resolution
+     * @note conversion is started with match rom for each sensor in id list
+     */
+    bool is_grouped()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        return !m_sensor_res.empty();
+    }
+
+    /**
+     * @brief groups id list by sensor resolution
+     * @param idlist list with 64bit id's
+     * @param groups receives id list for each resolution, index is RES_SENSOR_..
+     * @note each group can be read at rate of its conversion time
+     */
+    void group_resolution(const vector<sensor_id>& idlist, vector<vector<sensor_id>>& groups)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        groups.assign(RES_SENSOR_12 + 1, vector<sensor_id>());
+
+        for (const sensor_id& id: idlist)
+            groups[res_of(id)].push_back(id);
+    }
+
     /**
      * @brief scan for sensors
      * @param idlist list receives 64bit id's
@@ -220,6 +378,7 @@ public:
 
         // clear id list
         idlist.clear();
+        m_single = 0ULL;
 
         // repeated scan
         for (uint8_t r = 0; r < repeat; r++)
@@ -233,12 +392,15 @@ public:
                 case -2: // repeat search
                     break;
                 case -1: // error
+                    if (*get_error() == 0)
+                        print_error("ds18b20: no sensor");
                     return false;
                 case 0: // no more sensors
+                    set_single(idlist);
                     return true;
                 case 1: // id found
                     // check crc
-                    if ((_id >>56 ) == crc8((uint8_t*) &_id, 7))
+                    if ((_id >>56 ) == c_onewire::crc8((uint8_t*) &_id, 7))
                     {
                         r = 0; // reset repeat
                         id = _id;
@@ -251,530 +413,2356 @@ public:
         }
     
         // no sensor found
+        set_single(idlist);
         return true;
     }
 
     /**
-     * @brief read one sensors with given id
-     * @param s_id string id of sensor in format 28-HHHHHHHHHHHH (hex)
-     * @param fh fh true for fahrenheit, false for celsius
-     * @param temp temp receives temperature from sensor
-     * @param repeat number of reads attemps 1..
-     * @returns false if no sensor on bus or error
+     * @brief saves id list in cache file
+     * @param filename cache file
+     * @param idlist list with 64bit id's
+     * @returns true: ok, false: error
      */
-    bool read_sensor(const char* s_id, bool fh, double& temp, uint8_t repeat = 10)
+    bool save_ids(const char* filename, const vector<sensor_id>& idlist)
     {
-        const lock_guard<mutex> lock(m_mtx);
-
         // clear error
         clear_error();
 
-        sensor_id id;
-        
-        temp = INV_TEMP;
+        FILE* f = fopen(filename, "w");
 
-        // convert string id to 64bit id
-        if (!strtoid(s_id, id))
-            return false;
+        if (f == NULL)
+            return print_error("ds18b20: can not write id cache");
 
-        // send start sensor conversion
-        if (!start_convert())
-            return false;
-    
-        // waits depends on sensor resolution
-        switch(m_res)
-        {
-        case RES_SENSOR_9: // 100ms
-            m_timer.sleep_ms(100l);
-            break;
-        case RES_SENSOR_10: // 200ms
-            m_timer.sleep_ms(200l);
-            break;
-        case RES_SENSOR_11: // 400ms
-            m_timer.sleep_ms(400l);
-            break;
-        default:
-        case RES_SENSOR_12: // 800ms
-            m_timer.sleep_ms(800l);
-            break;
+        uint8_t crc = 0;
+
+        // one id per line, file checksum on last line
+        fprintf(f, "pin %d\n", m_bus.gpio().get_pin());
+
+        for (sensor_id id: idlist)
+        {
+            fprintf(f, "%016llX\n", id);
+            crc = crc_ids(crc, id);
         }
-    
-        // read sensor data
-        if (!read_sensor(&id, temp, repeat))
-            return false;
-    
-        // convert to fahrenheit
-        if (fh)
-            temp = temp * (9.0/5.0) + 32.0;
-    
+
+        fprintf(f, "crc %02X\n", crc);
+
+        if (fclose(f) != 0)
+            return print_error("ds18b20: can not write id cache");
+
         return true;
     }
 
     /**
-     * @brief read sensors from id list
-     * @param idlist list with 64bit id's
-     * @param fh fh true for fahrenheit, false for celsius
-     * @param templist list that receives temperatures from sensors
-     * @param repeat number of reads attemps 1..
-     * @returns false if no sensor on bus or error
-     * @note if error on read of one sensor, list are marked with INV_TEMP
+     * @brief loads id list from cache file
+     * @param filename cache file
+     * @param idlist list receives 64bit id's
+     * @returns true: ok, false: no file, other pin or checksum error
      */
-    bool read_sensors(vector<sensor_id>& idlist, bool fh, vector<double>& templist, uint8_t repeat = 10)
+    bool load_ids(const char* filename, vector<sensor_id>& idlist)
     {
-        const lock_guard<mutex> lock(m_mtx);
-
         // clear error
         clear_error();
 
-        // send start sensor conversion
-        if (!start_convert())
-            return false;
-    
-        // waits depends on sensor resolution
-        switch(m_res)
-        {
-        case RES_SENSOR_9:
-            m_timer.sleep_ms(100l);
-            break;
-        case RES_SENSOR_10:
-            m_timer.sleep_ms(200l);
-            break;
-        case RES_SENSOR_11:
-            m_timer.sleep_ms(400l);
-            break;
-        default:
-        case RES_SENSOR_12:
-            m_timer.sleep_ms(800l);
-            break;
-        }
-    
-        // clear temperature list
-        templist.clear();
+        idlist.clear();
 
-        double temp;
-    
-        // scan id list
-        for (sensor_id id: idlist)
+        FILE* f = fopen(filename, "r");
+
+        if (f == NULL)
+            return print_error("ds18b20: no id cache");
+
+        char line[40];
+        int32_t pin = -1;
+        uint32_t file_crc = 0x100;
+        uint8_t crc = 0;
+
+        while (fgets(line, sizeof(line), f) != NULL)
         {
-            // read sensor data
-            if (!read_sensor(&id, temp, repeat))
-            {
-                // mark invalid temp. in list
-                templist.push_back(INV_TEMP);
+            sensor_id id;
+
+            if (sscanf(line, "pin %d", &pin) == 1)
                 continue;
-            }
-    
-            // convert to fahrenheit
-            if (fh)
-                temp = temp * (9.0/5.0) + 32.0;
 
-            // add temperature in list
-            templist.push_back(temp);
+            if (sscanf(line, "crc %02X", &file_crc) == 1)
+                break;
+
+            // each id has own crc
+            if ((sscanf(line, "%16llX", &id) != 1) || ((id >> 56) != c_onewire::crc8((uint8_t*) &id, 7)))
+                break;
+
+            idlist.push_back(id);
+            crc = crc_ids(crc, id);
         }
-    
+
+        fclose(f);
+
+        if ((pin != m_bus.gpio().get_pin()) || (file_crc != crc))
+        {
+            idlist.clear();
+            return print_error("ds18b20: invalid id cache");
+        }
+
         return true;
     }
-        
-private:
-    // One wire command codes
-    enum {
-        SKIP_ROM   = 0xCC,
-        MATCH_ROM  = 0x55,
-        SEARCH_ROM = 0xF0,
-        COVERT_T   = 0x44,
-        WRITE_PAD  = 0x4E,
-        COPY_PAD   = 0x48,
-        READ_PAD   = 0xBE
-    };
 
     /**
-     * @brief clears error message
+     * @brief checks if sensor with given id answers
+     * @param id 64 bit sensor id
+     * @param repeat number of reads attemps 1..
+     * @returns true: sensor on bus, false: no sensor or error
+     * @note match rom and pad read with crc
      */
-    void clear_error()
+    bool verify_sensor(const sensor_id& id, uint8_t repeat = 10)
     {
-        m_gpio.clear_error();
-    }
+        const lock_guard<mutex> lock(m_mtx);
 
-    /**
-     * @brief prints error message if enabled on stderr
-     * @param msg message to print
-     * @returns always false
-     */
-    bool print_error(const char* msg)
-    {
-        return m_gpio.print_error(msg);
+        // clear error
+        clear_error();
+
+        return verify(id, repeat);
     }
 
     /**
-     * @brief crc calculation
-     * @param data points to data for calculation
-     * @param len length of data for calculation
-     * @returns crc value
+     * @brief scan for sensors with id cache
+     * @param filename cache file
+     * @param idlist list receives 64bit id's
+     * @param repeat number of scan attemps 1..
+     * @returns true: ok, false: error
+     * @note cached id's are verified, full search and new cache only on failure
+     * @note new sensors are not found while cache is valid
      */
-    uint8_t crc8(uint8_t *data, uint8_t len)
+    bool scan_sensor(const char* filename, vector<sensor_id>& idlist, uint8_t repeat = 10)
     {
-        uint8_t crc = 0;
-        
-        while (len--) {
-            uint8_t inbyte = *data++;
-            for (uint8_t i = 8; i; i--) {
-                uint8_t mix = (crc ^ inbyte) & 0x01;
-                crc >>= 1;
-                if (mix) crc ^= 0x8C;
-                inbyte >>= 1;
-            }
-        }
+        if (load_ids(filename, idlist) && (idlist.size() > 0) && verify_ids(idlist, repeat))
+            return true;
 
-        return crc;
+        // full search
+        if (!scan_sensor(idlist, repeat))
+            return false;
+
+        return save_ids(filename, idlist);
     }
 
     /**
-     * @brief resets 1-wire bus
-     * @returns false if no sensor on bus or error
+     * @brief incremental discovery of added and removed sensors
+     * @param idlist list of known 64bit id's, updated with changes
+     * @param added receives added id's
+     * @param removed receives removed id's
+     * @param steps max. rom search steps in this call, one step is one sensor
+     * @param repeat number of search attemps 1..
+     * @returns true: ok, false: error
+     * @note alarm search finds unconfigured sensors at once (alarm window of set_resolution never alarms),
+     * @note rom search walks tree in slices and continues on last branch point in next call,
+     * @note removed sensors are reported after tree walk is complete
      */
-    bool reset()
+    bool discover(vector<sensor_id>& idlist, vector<sensor_id>& added, vector<sensor_id>& removed, uint32_t steps = 4, uint8_t repeat = 10)
     {
-        int8_t bit = 1;
+        const lock_guard<mutex> lock(m_mtx);
 
-        // check for gpio error
-        if (!set_high())
-            return false;
+        // clear error
+        clear_error();
 
-        // 1-wire bus reset procedure
-        m_timer.delay_us(10l);
-        set_low();
-        m_timer.delay_us(500l);
-        set_high();
-        m_timer.delay_us(60l);
-        bit = read();
-        m_timer.sleep_ms(1l);
+        added.clear();
+        removed.clear();
 
-        // 1-wire bus must set to 0 on present sensors
-        if (bit != 0)
-            return print_error("ds18b20: no sensor");
+        // sensors with alarm flag, after conversion
+        sensor_id id = 0ULL, _id;
+        int8_t nextbit = 64, _nextbit;
 
-        return true;
-    }
+        for (uint8_t r = 0; r < repeat; r++)
+        {
+            _id = id;
+            _nextbit = nextbit;
 
-    /**
-     * @brief write pad command
-     * @param cfg sensor resolution
-     * @returns false if no sensor on bus or error
-     */
-    bool write_pad(uint8_t cfg)
-    {
-        c_priority priority;
+            // no alarm or end of alarm search
+            if (search_sensor(_id, _nextbit, OW_ALARM_SEARCH) != 1)
+                break;
 
-        // resets 1-wire bus
-        if (!reset())
-            return false;
+            if ((_id >> 56) != c_onewire::crc8((uint8_t*) &_id, 7))
+                continue;
 
-        // 1-wire set procedure for set pad
-		write_byte(SKIP_ROM);
-		write_byte(WRITE_PAD);
-		write_byte(0xFF); // TH
-		write_byte(0xFF); // TL
-		write_byte(cfg); // resolution
+            r = 0;
+            id = _id;
+            nextbit = _nextbit;
 
-		return true;
-    }
+            // sensor is seen in actual tree walk
+            if (find(m_walk_seen.begin(), m_walk_seen.end(), id) == m_walk_seen.end())
+                m_walk_seen.push_back(id);
+            add_id(idlist, added, id);
+        }
 
-    /**
-     * @brief starts conversion of sensors
-     * @returns false if no sensor on bus or error
-     */
-    bool start_convert()
-    {
-        c_priority priority;
+        clear_error();
 
-        // resets 1-wire bus
-        if (!reset())
-            return false;
+        // rom search continues on last branch point
+        for (uint32_t s = 0; s < steps; s++)
+        {
+            _id = m_walk_id;
+            _nextbit = m_walk_bit;
 
-        // send start conversion comand
-        write_byte(SKIP_ROM);
-        write_byte(COVERT_T);
+            switch(search_sensor(_id, _nextbit))
+            {
+                case -2: // repeat search
+                    break;
+                case -1: // error or no sensor on bus
+                    if (*get_error() != 0)
+                        return false;
 
-        return true;
-    }
+                    // all sensors removed
+                    m_walk_seen.clear();
+                    walk_end(idlist, removed);
+                    return true;
+                case 0: // tree walk complete
+                    walk_end(idlist, removed);
+                    return true;
+                case 1: // id found
+                    if ((_id >> 56) == c_onewire::crc8((uint8_t*) &_id, 7))
+                    {
+                        m_walk_r = 0;
+                        m_walk_id = _id;
+                        m_walk_bit = _nextbit;
+                        m_walk_seen.push_back(_id);
 
-    /**
-     * @brief read sensor temperature with given 64bit id
-     * @param id 64 bit sensor id 
-     * @param temp temperature to receive
-     * @param repeat number of reads attemps
-     * @returns true: valid read, false: no sensor read or error
+                        add_id(idlist, added, _id);
+                        continue;
+                    }
+                    break;
+            }
+
+            // restart tree walk after repeat attemps, no removes
+            if (++m_walk_r >= repeat)
+                walk_reset();
+        }
+
+        set_single(idlist);
+
+        return true;
+    }
+
+    /**
+     * @brief sets read mode
+     * @param mode READ_MODE_.. flags
+     * @note READ_MODE_NO_CRC detects only missing sensor (reads FF FF), no bit errors,
+     *       -0.0625°C has same bytes and is also read as missing sensor
      */
-    bool read_sensor(const sensor_id* id, double& temp, uint8_t repeat)
+    void set_read_mode(uint32_t mode)
     {
-        c_priority priority;
-    
-        uint8_t pad[9];
-    
-        // conversion of pad to short
-        union {
-            short SHORT;
-            unsigned char CHAR[2];
-        } u_temp;
-   
-        // read repeated
-        for (uint8_t i=0; i < repeat; i++)
+        const lock_guard<mutex> lock(m_mtx);
+        m_mode = mode;
+    }
+
+    /**
+     * @brief returns read mode
+     */
+    uint32_t get_read_mode() { return m_mode; }
+
+    /**
+     * @brief returns health statistics of sensor
+     * @param id 64 bit sensor id
+     * @param health receives statistics
+     * @returns false if sensor was never read
+     */
+    bool get_health(const sensor_id& id, ds18b20_health& health)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        auto it = m_health.find(id);
+
+        if (it == m_health.end())
+            return false;
+
+        health = it->second;
+
+        return true;
+    }
+
+    /**
+     * @brief returns true if sensor is quarantined
+     * @param id 64 bit sensor id
+     */
+    bool is_quarantined(const sensor_id& id)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        auto it = m_health.find(id);
+
+        return (it != m_health.end()) && it->second.quarantined;
+    }
+
+    /**
+     * @brief clears health statistics and quarantine of all sensors
+     */
+    void clear_health()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        m_health.clear();
+    }
+
+    /**
+     * @brief sets quarantine of failing sensors
+     * @param enable true: sensors with QUARANTINE_FAILS failed reads in sequence
+     *        are not read until back-off ends, back-off doubles on each failed probe
+     */
+    void set_quarantine(bool enable)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        m_quarantine = enable;
+
+        if (enable)
+            return;
+
+        for (auto& it: m_health)
+            it.second.quarantined = false;
+    }
+
+    /**
+     * @brief returns true if quarantine of failing sensors is on
+     */
+    bool get_quarantine() { return m_quarantine; }
+
+    /**
+     * @brief claims bus for driver of conversions
+     * @param driver pipeline, sampler or fleet
+     * @returns false if bus is claimed by other driver
+     * @note conversion state of bus is not shared, one driver per bus
+     */
+    bool attach(const void* driver)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        if ((m_driver != NULL) && (m_driver != driver))
+            return print_error("ds18b20: bus used by other driver");
+
+        m_driver = driver;
+
+        return true;
+    }
+
+    /**
+     * @brief releases bus of driver
+     * @param driver pipeline, sampler or fleet
+     */
+    void detach(const void* driver)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        if (m_driver == driver)
+            m_driver = NULL;
+    }
+
+    /**
+     * @brief returns conversion time of slowest sensor on bus
+     * @returns time in ns
+     */
+    int64_t get_convert_ns()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        return get_convert_ns(max_res());
+    }
+
+    /**
+     * @brief returns conversion time of resolution
+     * @param res sensor resolution RES_SENSOR_..
+     * @returns time in ns
+     */
+    static int64_t get_convert_ns(uint32_t res)
+    {
+        // conversion time depends on sensor resolution
+        switch(res)
+        {
+        case RES_SENSOR_9:
+            return 100000000l; // 100ms
+        case RES_SENSOR_10:
+            return 200000000l; // 200ms
+        case RES_SENSOR_11:
+            return 400000000l; // 400ms
+        default:
+        case RES_SENSOR_12:
+            return 800000000l; // 800ms
+        }
+    }
+
+    /**
+     * @brief returns config register of resolution
+     * @param res sensor resolution RES_SENSOR_..
+     */
+    static uint8_t res_cfg(uint32_t res)
+    {
+        // set parameter depends on on sensor resolution
+        switch(res)
+        {
+        case RES_SENSOR_9:
+            return 0x1f;
+        case RES_SENSOR_10:
+            return 0x3f;
+        case RES_SENSOR_11:
+            return 0x5f;
+        default:
+        case RES_SENSOR_12:
+            return 0x7f;
+        }
+    }
+
+    /**
+     * @brief starts conversion on all sensors on bus, does not wait
+     * @param ready_ns receives time when conversion is done (c_timer::now)
+     * @returns false if no sensor on bus or error
+     * @note read results with collect() after conversion_done()
+     */
+    bool start_conversion(int64_t& ready_ns)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        // send start sensor conversion
+        if (!start_convert(NULL))
+            return false;
+
+        converting(ready_ns, get_convert_ns(max_res()), true);
+
+        return true;
+    }
+
+    /**
+     * @brief starts conversion of sensors from id list, does not wait
+     * @param ready_ns receives time when slowest sensor in list is done (c_timer::now)
+     * @param idlist list with 64bit id's
+     * @returns false if no sensor on bus or error
+     * @note if sensors have own resolution only sensors in list convert (match rom),
+     *       so groups of sensors convert at rate of their resolution
+     */
+    bool start_conversion(int64_t& ready_ns, const vector<sensor_id>& idlist)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        // same resolution on bus, start all sensors at once
+        if (m_sensor_res.empty() || idlist.empty())
+        {
+            if (!start_convert(NULL))
+                return false;
+
+            converting(ready_ns, get_convert_ns(max_res()), true);
+
+            return true;
+        }
+
+        uint32_t res = RES_SENSOR_9;
+
+        // start each sensor in list
+        for (const sensor_id& id: idlist)
         {
-            // reset 1-wire bus
-            if (!reset())
+            if (!start_convert(&id))
                 return false;
+
+            res = max(res, res_of(id));
+        }
+
+        // only last started sensor answers read slots
+        converting(ready_ns, get_convert_ns(res), idlist.size() == 1);
+
+        return true;
+    }
+
+    /**
+     * @brief reads power supply of sensors on bus
+     * @param parasite receives true if any sensor is parasite powered
+     * @returns false if no sensor on bus or error
+     */
+    bool read_power_supply(bool& parasite)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        c_ow_transaction ta(m_bus);
+
+        if (!select(NULL))
+            return false;
+
+        // parasite powered sensors pull bus low
+        m_bus.write_byte(READ_POWER);
+        parasite = m_bus.read_bit() == 0;
+
+        return true;
+    }
+
+    /**
+     * @brief sets polling of conversion complete
+     * @param enable true: poll read slots with back-off, false: fixed wait
+     * @returns false if no sensor on bus or error
+     * @note parasite powered buses always use fixed wait
+     */
+    bool set_poll_convert(bool enable)
+    {
+        bool parasite = false;
+
+        if (enable && !read_power_supply(parasite))
+            return false;
+
+        m_poll = enable && !parasite;
+
+        return true;
+    }
+
+    /**
+     * @brief returns true if polling of conversion complete is on
+     */
+    bool get_poll_convert() { return m_poll; }
+
+    /**
+     * @brief checks if conversion of last start_conversion() is done
+     * @returns true: done, false: converting
+     * @note without polling true after fixed conversion time
+     */
+    bool conversion_done()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        int64_t now = c_timer::now();
+
+        if (now >= m_ready_ns)
+            return true;
+
+        if (!m_conv_poll || (now < m_poll_ns))
+            return false;
+
+        bool done;
+
+        // sensors send 1 if conversion is done
+        {
+            c_ow_transaction ta(m_bus);
+            done = m_bus.read_bit() == 1;
+        }
+
+        if (done)
+        {
+            m_conv_poll = false;
+            m_ready_ns = now;
+            return true;
+        }
+
+        // back-off
+        m_poll_interval = min(m_poll_interval * 2, m_conv_ns / POLL_CONVERT_DIV);
+        m_poll_ns = now + m_poll_interval;
+
+        return false;
+    }
+
+    /**
+     * @brief returns time of next conversion_done() check
+     * @returns time in ns (c_timer::now)
+     */
+    int64_t get_check_ns()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        return m_conv_poll ? min(m_poll_ns, m_ready_ns) : m_ready_ns;
+    }
+
+    /**
+     * @brief waits until conversion of last start_conversion() is done
+     */
+    void wait_conversion()
+    {
+        while (!conversion_done())
+            m_timer.sleep_until(get_check_ns());
+    }
+
+    /**
+     * @brief read sensors from id list after conversion, does not wait
+     * @param idlist list with 64bit id's
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param templist list that receives temperatures from sensors
+     * @param repeat number of reads attemps 1..
+     * @returns false on error
+     * @note if error on read of one sensor, list are marked with INV_TEMP
+     */
+    bool collect(const vector<sensor_id>& idlist, bool fh, vector<double>& templist, uint8_t repeat = 10)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        // clear temperature list
+        templist.clear();
+
+        double temp;
     
-            // send 1-wire match rom command
-            write_byte(MATCH_ROM);
-            write_block((const uint8_t*) id, 8);
+        // scan id list
+        for (sensor_id id: idlist)
+        {
+            // read sensor data
+            if (!read_sensor(&id, temp, repeat))
+            {
+                // mark invalid temp. in list
+                templist.push_back(INV_TEMP);
+                continue;
+            }
+    
+            // convert to fahrenheit
+            if (fh)
+                temp = temp * (9.0/5.0) + 32.0;
+
+            // add temperature in list
+            templist.push_back(temp);
+        }
+    
+        return true;
+    }
+
+    /**
+     * @brief read one sensors with given id
+     * @param s_id string id of sensor in format 28-HHHHHHHHHHHH (hex)
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param temp temp receives temperature from sensor
+     * @param repeat number of reads attemps 1..
+     * @returns false if no sensor on bus or error
+     * @note bus is not locked while waiting for conversion
+     */
+    bool read_sensor(const char* s_id, bool fh, double& temp, uint8_t repeat = 10)
+    {
+        sensor_id id;
+        int64_t ready_ns;
+        
+        temp = INV_TEMP;
+
+        // convert string id to 64bit id
+        if (!strtoid(s_id, id))
+            return false;
+
+        // send start sensor conversion
+        if (!start_conversion(ready_ns, { id }))
+            return false;
+    
+        // waits until conversion is done
+        wait_conversion();
+
+        vector<double> templist;
+
+        // read sensor data
+        if (!collect({ id }, fh, templist, repeat) || (templist[0] == INV_TEMP))
+            return false;
+    
+        temp = templist[0];
+    
+        return true;
+    }
+
+    /**
+     * @brief read sensors from id list
+     * @param idlist list with 64bit id's
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param templist list that receives temperatures from sensors
+     * @param repeat number of reads attemps 1..
+     * @returns false if no sensor on bus or error
+     * @note if error on read of one sensor, list are marked with INV_TEMP
+     * @note bus is not locked while waiting for conversion
+     */
+    bool read_sensors(vector<sensor_id>& idlist, bool fh, vector<double>& templist, uint8_t repeat = 10)
+    {
+        int64_t ready_ns;
+
+        // send start sensor conversion
+        if (!start_conversion(ready_ns, idlist))
+            return false;
+    
+        // waits until conversion is done
+        wait_conversion();
+
+        // read sensors data
+        return collect(idlist, fh, templist, repeat);
+    }
+        
+private:
+    // sensor command codes
+    enum {
+        COVERT_T   = 0x44,
+        WRITE_PAD  = 0x4E,
+        COPY_PAD   = 0x48,
+        READ_PAD   = 0xBE,
+        READ_POWER = 0xB4
+    };
+
+    /**
+     * @brief clears error message
+     */
+    void clear_error()
+    {
+        m_bus.clear_error();
+    }
+
+    /**
+     * @brief prints error message if enabled on stderr
+     * @param msg message to print
+     * @returns always false
+     */
+    bool print_error(const char* msg)
+    {
+        return m_bus.print_error(msg);
+    }
+
+    /**
+     * @brief resets 1-wire bus and selects sensors
+     * @param id 64 bit sensor id, NULL: all sensors
+     * @returns false if no sensor on bus or error
+     */
+    bool select(const sensor_id* id)
+    {
+        // reset ends polling of conversion
+        m_conv_poll = false;
+
+        if (m_bus.select(id))
+            return true;
+
+        // gpio error has message
+        if (*get_error() != 0)
+            return false;
+
+        return print_error("ds18b20: no sensor");
+    }
+
+    /**
+     * @brief returns resolution of sensor, no lock
+     * @param id 64 bit sensor id
+     */
+    uint32_t res_of(const sensor_id& id)
+    {
+        auto it = m_sensor_res.find(id);
+
+        return (it == m_sensor_res.end()) ? m_res : it->second;
+    }
+
+    /**
+     * @brief returns resolution of slowest sensor on bus, no lock
+     */
+    uint32_t max_res()
+    {
+        uint32_t res = m_res;
+
+        for (auto& it: m_sensor_res)
+            res = max(res, it.second);
+
+        return res;
+    }
+
+    /**
+     * @brief write pad command
+     * @param id 64 bit sensor id, NULL: all sensors
+     * @param cfg config register with resolution
+     * @param th alarm high temp. in °C
+     * @param tl alarm low temp. in °C
+     * @returns false if no sensor on bus or error
+     */
+    bool write_pad(const sensor_id* id, uint8_t cfg, int8_t th, int8_t tl)
+    {
+        c_ow_transaction ta(m_bus);
+
+        // resets 1-wire bus
+        if (!select(id))
+            return false;
+
+        // 1-wire set procedure for set pad
+        m_bus.write_byte(WRITE_PAD);
+        m_bus.write_byte((uint8_t) th); // TH
+        m_bus.write_byte((uint8_t) tl); // TL
+        m_bus.write_byte(cfg); // resolution
+
+        return true;
+    }
+
+    /**
+     * @brief copies pad (TH, TL, config) to eeprom of sensor
+     * @param id 64 bit sensor id, NULL: all sensors
+     * @returns false if no sensor on bus or error
+     * @note parasite powered sensors need strong pullup while copy
+     */
+    bool copy_pad(const sensor_id* id)
+    {
+        {
+            c_ow_transaction ta(m_bus);
+
+            if (!select(id))
+                return false;
+
+            m_bus.write_byte(COPY_PAD);
+        }
+
+        // eeprom write takes max. 10ms
+        m_timer.sleep_ms(10);
+
+        return true;
+    }
+
+    /**
+     * @brief reads pad with crc check
+     * @param id 64 bit sensor id
+     * @param pad receives 9 byte pad
+     * @param repeat number of reads attemps
+     * @returns false if no valid read or error
+     */
+    bool read_pad(const sensor_id* id, uint8_t* pad, uint8_t repeat)
+    {
+        c_ow_transaction ta(m_bus);
+
+        for (uint8_t i = 0; i < repeat; i++)
+        {
+            if (!select(id))
+                return false;
+
+            m_bus.write_byte(READ_PAD);
+            m_bus.read_block(pad, 9);
+
+            if (c_onewire::crc8(pad, 8) == pad[8])
+                return true;
+        }
+
+        return print_error("ds18b20: no sensor read");
+    }
+
+    /**
+     * @brief sets state of started conversion
+     * @param ready_ns receives time when conversion is done
+     * @param convert_ns conversion time
+     * @param poll true: started sensors answer read slots
+     */
+    void converting(int64_t& ready_ns, int64_t convert_ns, bool poll)
+    {
+        int64_t now = c_timer::now();
+
+        ready_ns = now + convert_ns;
+
+        // sensors answer read slots after convert command
+        m_ready_ns = ready_ns;
+        m_conv_ns = convert_ns;
+        m_conv_poll = m_poll && poll;
+        m_poll_interval = POLL_CONVERT_MIN;
+        m_poll_ns = now + m_poll_interval;
+    }
+
+    /**
+     * @brief starts conversion of sensors
+     * @param id 64 bit sensor id, NULL: all sensors
+     * @returns false if no sensor on bus or error
+     */
+    bool start_convert(const sensor_id* id)
+    {
+        c_ow_transaction ta(m_bus);
+
+        // resets 1-wire bus
+        if (!select(id))
+            return false;
+
+        // send start conversion comand
+        m_bus.write_byte(COVERT_T);
+
+        return true;
+    }
+
+    /**
+     * @brief read sensor temperature with given 64bit id
+     * @param id 64 bit sensor id 
+     * @param temp temperature to receive
+     * @param repeat number of reads attemps
+     * @returns true: valid read, false: no sensor read, quarantined or error
+     * @note failing sensors get less read attemps
+     */
+    bool read_sensor(const sensor_id* id, double& temp, uint8_t repeat)
+    {
+        ds18b20_health& h = m_health[*id];
+
+        int64_t now = c_timer::now();
+
+        // no bus time until back-off ends
+        if (h.quarantined && (now < h.retry_ns))
+        {
+            h.skips++;
+            return print_error("ds18b20: sensor quarantined, read skipped");
+        }
+
+        // adaptive retry budget, halves on each failed read, one probe in quarantine
+        uint8_t budget = h.quarantined ? 1 : max(repeat >> min(h.fails, 7U), 1);
+
+        h.reads++;
+
+        if (read_temp(id, temp, budget, h))
+        {
+            h.valid++;
+            h.fails = 0;
+            h.quarantined = false;
+            h.backoff_ns = 0;
+
+            return true;
+        }
+
+        h.fails++;
+
+        // failed probe, double back-off
+        if (h.quarantined)
+        {
+            h.backoff_ns = min(h.backoff_ns * 2, QUARANTINE_MAX_NS);
+            h.retry_ns = now + h.backoff_ns;
+        }
+        else if (m_quarantine && (h.fails >= QUARANTINE_FAILS))
+        {
+            h.quarantined = true;
+            h.quarantines++;
+            h.backoff_ns = QUARANTINE_MIN_NS;
+            h.retry_ns = now + h.backoff_ns;
+
+            // gpio error has message
+            if (*get_error() == 0)
+                return print_error("ds18b20: sensor quarantined");
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief read sensor pad and counts errors
+     * @param id 64 bit sensor id 
+     * @param temp temperature to receive
+     * @param repeat number of reads attemps
+     * @param h health statistics of sensor
+     * @returns true: valid read, false: no sensor read or error
+     */
+    bool read_temp(const sensor_id* id, double& temp, uint8_t repeat, ds18b20_health& h)
+    {
+        c_ow_transaction ta(m_bus);
+    
+        uint8_t pad[9];
+
+        // skip rom on single sensor, no id bytes on bus
+        if ((m_mode & READ_MODE_SKIP_ROM) && (m_single != 0ULL) && (*id == m_single))
+            id = NULL;
+
+        // without crc read only temperature
+        uint8_t len = (m_mode & READ_MODE_NO_CRC) ? 2 : 9;
+    
+        // conversion of pad to short
+        union {
+            short SHORT;
+            unsigned char CHAR[2];
+        } u_temp;
+   
+        // read repeated
+        for (uint8_t i=0; i < repeat; i++)
+        {
+            // reset 1-wire bus and send match or skip rom
+            if (!select(id))
+            {
+                h.timeouts++;
+                return false;
+            }
+
+            // read sensor pad, next reset ends truncated read
+            memset(&pad, 0, sizeof(pad));
+            m_bus.write_byte(READ_PAD);
+            m_bus.read_block((uint8_t*) &pad, len);
+
+            if (len == 9)
+            {
+                // released bus reads 0xFF, no sensor with id, no repeat
+                if (all_of(pad, pad + 9, [](uint8_t b) { return b == 0xFF; }))
+                {
+                    h.timeouts++;
+                    break;
+                }
+
+                // check crc, on mismatch continue read
+                if (c_onewire::crc8((uint8_t*) &pad, 8) != pad[8])
+                {
+                    h.crc_errors++;
+                    continue;
+                }
+
+                // 85°C with reset value in pad, sensor lost conversion, no repeat
+                if ((pad[0] == 0x50) && (pad[1] == 0x05) && (pad[6] == 0x0C))
+                {
+                    h.power_on++;
+                    break;
+                }
+            }
+            else
+            {
+                // released bus reads 0xFF, no sensor with id, no repeat
+                if ((pad[0] == 0xFF) && (pad[1] == 0xFF))
+                {
+                    h.timeouts++;
+                    break;
+                }
+            }
+    
+            // set convert parameter
+            u_temp.CHAR[0] = pad[0];
+            u_temp.CHAR[1] = pad[1];
+    
+            // convert to °C
+            temp =  0.0625 * (double)u_temp.SHORT;
+    
+            return true;
+        }
+    
+        return print_error("ds18b20: no sensor read");
+    }
+
+    /**
+     * @brief verifies cached id's
+     * @param idlist list with 64bit id's
+     * @param repeat number of reads attemps
+     * @returns true: all sensors answer
+     */
+    bool verify_ids(const vector<sensor_id>& idlist, uint8_t repeat)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        m_single = 0ULL;
+
+        // read rom is valid only with single sensor on bus
+        if (idlist.size() == 1)
+        {
+            sensor_id id;
+
+            if (read_rom(id) && (id == idlist[0]))
+            {
+                m_single = id;
+                return true;
+            }
+        }
+
+        for (const sensor_id& id: idlist)
+            if (!verify(id, repeat))
+                return false;
+
+        clear_error();
+
+        return true;
+    }
+
+    /**
+     * @brief checks if sensor with given id answers
+     * @param id 64 bit sensor id
+     * @param repeat number of reads attemps
+     * @returns true: sensor on bus, false: no sensor or error
+     */
+    bool verify(const sensor_id& id, uint8_t repeat)
+    {
+        c_ow_transaction ta(m_bus);
+
+        uint8_t pad[9];
+
+        for (uint8_t i = 0; i < repeat; i++)
+        {
+            if (!select(&id))
+                return false;
+
+            m_bus.write_byte(READ_PAD);
+            m_bus.read_block(pad, 9);
+
+            // released bus reads 0xFF
+            bool released = true;
+
+            for (uint8_t b: pad)
+                if (b != 0xFF)
+                    released = false;
+
+            // no sensor with id, no repeat
+            if (released)
+                break;
+
+            if (c_onewire::crc8(pad, 8) == pad[8])
+                return true;
+        }
+
+        return print_error("ds18b20: sensor not verified");
+    }
+
+    /**
+     * @brief reads rom id of single sensor on bus
+     * @param id receives 64 bit sensor id
+     * @returns true: valid id, false: no sensor, many sensors or error
+     */
+    bool read_rom(sensor_id& id)
+    {
+        c_ow_transaction ta(m_bus);
+
+        // reset ends polling of conversion
+        m_conv_poll = false;
+
+        if (!m_bus.reset())
+            return false;
+
+        // many sensors answer at same time and crc fails
+        m_bus.write_byte(OW_READ_ROM);
+        m_bus.read_block((uint8_t*) &id, 8);
+
+        return (id >> 56) == c_onewire::crc8((uint8_t*) &id, 7);
+    }
+
+    /**
+     * @brief adds id to checksum of id cache
+     */
+    static uint8_t crc_ids(uint8_t crc, sensor_id id)
+    {
+        uint8_t data[8];
+
+        // id without own crc, else crc of id is always 0
+        data[0] = crc;
+        memcpy(data + 1, &id, 7);
+
+        return c_onewire::crc8(data, 8);
+    }
+
+    /**
+     * @brief remembers sensor if single sensor on bus
+     * @param idlist list with 64bit id's of bus
+     */
+    void set_single(const vector<sensor_id>& idlist)
+    {
+        m_single = (idlist.size() == 1) ? idlist[0] : 0ULL;
+    }
+
+    /**
+     * @brief adds id to list if new
+     * @param idlist list of known 64bit id's
+     * @param added list of added id's
+     * @param id 64 bit sensor id
+     */
+    static void add_id(vector<sensor_id>& idlist, vector<sensor_id>& added, sensor_id id)
+    {
+        if (find(idlist.begin(), idlist.end(), id) != idlist.end())
+            return;
+
+        idlist.push_back(id);
+        added.push_back(id);
+    }
+
+    /**
+     * @brief ends tree walk, known id's not seen are removed
+     * @param idlist list of known 64bit id's
+     * @param removed list of removed id's
+     */
+    void walk_end(vector<sensor_id>& idlist, vector<sensor_id>& removed)
+    {
+        for (auto it = idlist.begin(); it != idlist.end();)
+        {
+            if (find(m_walk_seen.begin(), m_walk_seen.end(), *it) == m_walk_seen.end())
+            {
+                removed.push_back(*it);
+                it = idlist.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        walk_reset();
+        set_single(idlist);
+    }
+
+    /**
+     * @brief starts new tree walk
+     */
+    void walk_reset()
+    {
+        m_walk_id = 0ULL;
+        m_walk_bit = 64;
+        m_walk_r = 0;
+        m_walk_seen.clear();
+    }
+
+    /**
+     * @brief scan for sensors
+     * @param id 64 bit sensor id 
+     * @param lastbit bit position 
+     * @param cmd OW_SEARCH_ROM or OW_ALARM_SEARCH
+     * @returns -2: repeat, -1: error or no sensor, 0: no more sensors, 1: sensor found
+     */
+    int8_t search_sensor(sensor_id& id, int8_t& lastbit, uint8_t cmd = OW_SEARCH_ROM)
+    {
+        c_ow_transaction ta(m_bus);
+
+        // reset ends polling of conversion
+        m_conv_poll = false;
+
+        // no message if no sensor on bus
+        return m_bus.search(cmd, id, lastbit);
+    }
+
+    c_onewire m_bus;  // 1-wire bus
+    c_timer m_timer;  // used for sleep
+    uint32_t m_res;   // saved resolution
+    mutex m_mtx;      // lock mutex
+
+    uint32_t m_mode;        // read mode READ_MODE_..
+    sensor_id m_single;     // single sensor on bus, 0: none or many
+    atomic_bool m_poll;     // polling of conversion complete on, set without lock
+    bool m_conv_poll;       // actual conversion can be polled
+    int64_t m_ready_ns;     // conversion done at latest
+    int64_t m_poll_ns;      // time of next poll
+    int64_t m_poll_interval; // actual poll interval
+    int64_t m_conv_ns;      // conversion time of actual conversion
+    map<sensor_id, uint32_t> m_sensor_res; // own resolution of sensors
+    map<sensor_id, ds18b20_health> m_health; // health statistics of sensors
+    bool m_quarantine;      // quarantine of failing sensors on
+    const void* m_driver;   // pipeline, sampler or fleet of bus, NULL: none
+
+    sensor_id m_walk_id;    // last id of tree walk
+    int8_t m_walk_bit;      // last branch point of tree walk
+    uint8_t m_walk_r;       // repeat counter of tree walk
+    vector<sensor_id> m_walk_seen; // id's seen in tree walk
+};
+
+// result callback of conversion pipeline
+typedef function<void(bool ok, vector<double>& templist)> ds18b20_callback;
+
+/**
+ * @brief class c_ds18b20_pipeline
+ *
+ * non-blocking conversion pipeline for many buses in one thread,
+ * start conversion and collect results are steps of a state machine,
+ * while one bus converts, other buses are started or collected,
+ * on buses with own sensor resolutions groups of sensors convert at same time
+ * @note not thread-safe, add and poll from same thread
+ * @note bus with requests is claimed, not used by sampler, fleet or other pipeline
+ */
+class c_ds18b20_pipeline
+{
+public:
+    /**
+     * @brief releases buses on destroy
+     */
+    ~c_ds18b20_pipeline()
+    {
+        for (job& j: m_jobs)
+            j.bus->detach(this);
+    }
+
+    /**
+     * @brief adds read request, result with callback
+     * @param bus ds18b20 bus
+     * @param idlist list with 64bit id's
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param callback called with result in poll()
+     * @param repeat number of reads attemps 1..
+     */
+    void add(c_ds18b20* bus, const vector<sensor_id>& idlist, bool fh, ds18b20_callback callback, uint8_t repeat = 10)
+    {
+        job j;
+
+        j.bus = bus;
+        j.idlist = idlist;
+        j.fh = fh;
+        j.repeat = repeat;
+        j.callback = callback;
+        j.converting = false;
+        j.grouped = false;
+        j.ready_ns = 0;
+
+        m_jobs.push_back(move(j));
+    }
+
+    /**
+     * @brief adds read request, result with future
+     * @param bus ds18b20 bus
+     * @param idlist list with 64bit id's
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param repeat number of reads attemps 1..
+     * @returns future with temperature list, empty list on error
+     */
+    future<vector<double>> add(c_ds18b20* bus, const vector<sensor_id>& idlist, bool fh, uint8_t repeat = 10)
+    {
+        auto result = make_shared<promise<vector<double>>>();
+
+        add(bus, idlist, fh, [result](bool ok, vector<double>& templist)
+        {
+            if (!ok)
+                templist.clear();
+
+            result->set_value(templist);
+        }, repeat);
+
+        return result->get_future();
+    }
+
+    /**
+     * @brief returns count of requests in pipeline
+     */
+    size_t pending() { return m_jobs.size(); }
+
+    /**
+     * @brief runs pipeline steps that are due, does not wait
+     * @returns time of next step (c_timer::now), 0: pipeline empty
+     */
+    int64_t poll()
+    {
+        int64_t next = 0;
+
+        for (auto it = m_jobs.begin(); it != m_jobs.end();)
+        {
+            job& j = *it;
+
+            // start conversion of sensors in request
+            if (!j.converting)
+            {
+                if (busy(j))
+                {
+                    ++it;
+                    continue;
+                }
+
+                j.grouped = j.bus->is_grouped();
+
+                if (!j.bus->attach(this) || !j.bus->start_conversion(j.ready_ns, j.idlist))
+                {
+                    j.callback(false, j.templist);
+                    it = release(it);
+                    continue;
+                }
+
+                j.converting = true;
+            }
+
+            // conversion not done, polls bus if enabled, groups use fixed wait
+            if (j.grouped ? (c_timer::now() < j.ready_ns) : !j.bus->conversion_done())
+            {
+                int64_t check_ns = j.grouped ? j.ready_ns : j.bus->get_check_ns();
+
+                if ((next == 0) || (check_ns < next))
+                    next = check_ns;
+
+                ++it;
+                continue;
+            }
+
+            // collect results
+            bool ok = j.bus->collect(j.idlist, j.fh, j.templist, j.repeat);
+
+            j.callback(ok, j.templist);
+            it = release(it);
+
+            // start waiting requests on same bus now
+            next = c_timer::now();
+        }
+
+        return m_jobs.empty() ? 0 : next;
+    }
+
+    /**
+     * @brief runs pipeline until all requests are done
+     */
+    void run()
+    {
+        int64_t next;
+
+        while ((next = poll()) != 0)
+            m_timer.sleep_until(next);
+    }
+
+private:
+    // read request
+    struct job {
+        c_ds18b20* bus;           // ds18b20 bus
+        vector<sensor_id> idlist; // sensors to read
+        vector<double> templist;  // temperatures read
+        bool fh;                  // fahrenheit flag
+        uint8_t repeat;           // number of reads attemps
+        ds18b20_callback callback; // result callback
+        bool converting;          // conversion started
+        bool grouped;             // only sensors of request convert
+        int64_t ready_ns;         // conversion done time
+    };
+
+    // returns true if conversion of request can not start now
+    bool busy(const job& j)
+    {
+        bool grouped = j.bus->is_grouped();
+
+        for (job& c: m_jobs)
+        {
+            if (!c.converting || (c.bus != j.bus))
+                continue;
+
+            // conversion of all sensors, one conversion per bus
+            if (!grouped || !c.grouped)
+                return true;
+
+            // groups convert at same time, sensor in one conversion only
+            for (sensor_id id: j.idlist)
+                if (find(c.idlist.begin(), c.idlist.end(), id) != c.idlist.end())
+                    return true;
+        }
+
+        return false;
+    }
+
+    // removes request, releases bus without other requests
+    list<job>::iterator release(list<job>::iterator it)
+    {
+        c_ds18b20* bus = it->bus;
+
+        it = m_jobs.erase(it);
+
+        for (job& j: m_jobs)
+            if (j.bus == bus)
+                return it;
+
+        bus->detach(this);
+
+        return it;
+    }
+
+    list<job> m_jobs; // requests in pipeline
+    c_timer m_timer;  // used for sleep
+};
+
+// quality flags of sampled value
+enum {
+    SAMPLE_OK    = 0, // valid value of last sweep
+    SAMPLE_NONE  = 1, // no valid value sampled yet
+    SAMPLE_ERROR = 2, // read of last sweep failed, value of older sweep
+    SAMPLE_STALE = 4, // value older than two periods
+    SAMPLE_QUARANTINED = 8, // sensor is quarantined
+};
+
+/**
+ * @brief sampled value of sensor
+ */
+struct ds18b20_sample {
+    double temp;      // last valid temperature, INV_TEMP if none
+    int64_t time_ns;  // time of last valid value (c_timer::now)
+    uint32_t quality; // SAMPLE_.. flags
+    uint32_t errors;  // failed reads in sequence
+};
+
+/**
+ * @brief class c_ds18b20_sampler
+ *
+ * background thread reads all sensors of bus periodic,
+ * latest values are published with seqlock,
+ * any number of threads read values without lock and bus access
+ */
+class c_ds18b20_sampler
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_ds18b20_sampler()
+    {
+        m_bus = NULL;
+        m_period = 0;
+        m_fh = false;
+        m_repeat = 10;
+        m_stop = true;
+        m_sweeps = 0;
+        m_overruns = 0;
+    }
+
+    /**
+     * @brief stops thread on destroy
+     */
+    ~c_ds18b20_sampler()
+    {
+        stop();
+    }
+
+    /**
+     * @brief starts sampling thread
+     * @param bus ds18b20 bus
+     * @param idlist list with 64bit id's
+     * @param period_ns sample period in ns
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param repeat number of reads attemps 1..
+     * @returns false if already started, invalid parameter or bus used by other driver
+     * @note id list is fixed while sampling, values have same index as id list
+     * @note bus is claimed until stop, not used by pipeline, fleet or other sampler
+     */
+    bool start(c_ds18b20* bus, const vector<sensor_id>& idlist, int64_t period_ns, bool fh = false, uint8_t repeat = 10)
+    {
+        if (!m_stop || (bus == NULL) || (period_ns <= 0))
+            return false;
+
+        if (!bus->attach(this))
+            return false;
+
+        m_bus = bus;
+        m_ids = idlist;
+        m_period = period_ns;
+        m_fh = fh;
+        m_repeat = repeat;
+        m_sweeps = 0;
+        m_overruns = 0;
+
+        // no value yet
+        ds18b20_sample sample = { INV_TEMP, 0, SAMPLE_NONE, 0 };
+
+        m_last.assign(m_ids.size(), sample);
+        m_values.reset(new c_seqlock<ds18b20_sample>[m_ids.size()]);
+
+        for (size_t i = 0; i < m_ids.size(); i++)
+            m_values[i].store(sample);
+
+        m_stop = false;
+        m_thread = thread(&c_ds18b20_sampler::execute, this);
+
+        return true;
+    }
+
+    /**
+     * @brief stops sampling thread
+     * @note waits until actual sweep is done
+     */
+    void stop()
+    {
+        {
+            const lock_guard<mutex> lock(m_mtx);
+            m_stop = true;
+        }
+
+        m_cv.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        if (m_bus != NULL)
+            m_bus->detach(this);
+    }
+
+    /**
+     * @brief returns count of sensors
+     */
+    size_t get_count() { return m_ids.size(); }
+
+    /**
+     * @brief returns id list of sensors
+     */
+    const vector<sensor_id>& get_ids() { return m_ids; }
+
+    /**
+     * @brief returns latest value of sensor, no lock
+     * @param idx index of sensor in id list
+     * @param sample receives value
+     * @returns false if invalid index
+     */
+    bool get(size_t idx, ds18b20_sample& sample)
+    {
+        if (idx >= m_ids.size())
+            return false;
+
+        m_values[idx].load(sample);
+
+        // missed sweeps
+        if (!(sample.quality & SAMPLE_NONE) && (c_timer::now() - sample.time_ns > 2 * m_period))
+            sample.quality |= SAMPLE_STALE;
+
+        return true;
+    }
+
+    /**
+     * @brief returns latest value of sensor, no lock
+     * @param id 64 bit sensor id
+     * @param sample receives value
+     * @returns false if sensor is not sampled
+     */
+    bool get_id(const sensor_id& id, ds18b20_sample& sample)
+    {
+        auto it = find(m_ids.begin(), m_ids.end(), id);
+
+        if (it == m_ids.end())
+            return false;
+
+        return get((size_t) (it - m_ids.begin()), sample);
+    }
+
+    /**
+     * @brief returns latest values of all sensors, no lock
+     * @param samples receives values in order of id list
+     */
+    void get_all(vector<ds18b20_sample>& samples)
+    {
+        samples.resize(m_ids.size());
+
+        for (size_t i = 0; i < m_ids.size(); i++)
+            get(i, samples[i]);
+    }
+
+    /**
+     * @brief returns count of sweeps over all sensors
+     */
+    uint64_t get_sweeps() { return m_sweeps; }
+
+    /**
+     * @brief returns count of missed periods
+     */
+    uint64_t get_overruns() { return m_overruns; }
+
+private:
+    /**
+     * @brief sampling thread
+     */
+    void execute()
+    {
+        int64_t next = c_timer::now();
+
+        unique_lock<mutex> lock(m_mtx);
+
+        while (!m_stop)
+        {
+            lock.unlock();
+            sweep();
+            lock.lock();
+
+            // next period, skip missed periods
+            next += m_period;
+
+            int64_t t = c_timer::now();
+
+            if (t >= next)
+            {
+                int64_t missed = (t - next) / m_period + 1;
+                m_overruns += missed;
+                next += missed * m_period;
+            }
+
+            // steady clock is monotonic clock of c_timer
+            m_cv.wait_until(lock, chrono::steady_clock::time_point(chrono::nanoseconds(next)), [this]() { return m_stop; });
+        }
+    }
+
+    /**
+     * @brief reads all sensors and publishes values
+     */
+    void sweep()
+    {
+        int64_t ready_ns;
+
+        // sensors measure at start of conversion
+        int64_t time_ns = c_timer::now();
+
+        bool ok = m_bus->start_conversion(ready_ns, m_ids);
+
+        if (ok)
+        {
+            m_bus->wait_conversion();
+            ok = m_bus->collect(m_ids, m_fh, m_templist, m_repeat);
+        }
+
+        for (size_t i = 0; i < m_ids.size(); i++)
+        {
+            ds18b20_sample& sample = m_last[i];
+
+            if (ok && (i < m_templist.size()) && (m_templist[i] != INV_TEMP))
+            {
+                sample.temp = m_templist[i];
+                sample.time_ns = time_ns;
+                sample.quality = SAMPLE_OK;
+                sample.errors = 0;
+            }
+            else
+            {
+                // keep last valid value
+                sample.quality = (sample.quality & SAMPLE_NONE) | SAMPLE_ERROR;
+                sample.errors++;
+
+                if (m_bus->is_quarantined(m_ids[i]))
+                    sample.quality |= SAMPLE_QUARANTINED;
+            }
+
+            m_values[i].store(sample);
+        }
+
+        m_sweeps++;
+    }
+
+    c_ds18b20* m_bus;           // ds18b20 bus
+    vector<sensor_id> m_ids;    // sampled sensors
+    int64_t m_period;           // sample period in ns
+    bool m_fh;                  // fahrenheit flag
+    uint8_t m_repeat;           // number of reads attemps
+    vector<ds18b20_sample> m_last; // values of thread
+    vector<double> m_templist;  // temperatures of sweep
+    unique_ptr<c_seqlock<ds18b20_sample>[]> m_values; // published values
+
+    thread m_thread;            // sampling thread
+    mutex m_mtx;                // lock of stop flag
+    condition_variable m_cv;    // wakes thread on stop
+    bool m_stop;                // stop flag
+    atomic_uint64_t m_sweeps;   // count of sweeps
+    atomic_uint64_t m_overruns; // count of missed periods
+};
+
+// result callback of fleet scheduler
+typedef function<void(c_ds18b20* bus, const sensor_id& id, bool ok, double temp)> ds18b20_fleet_callback;
+
+/**
+ * @brief class c_ds18b20_fleet
+ *
+ * one scheduler for sensors on many buses in one thread,
+ * conversions of different buses overlap, buses with earliest deadline first,
+ * sample interval of each sensor adapts to rate of change of temperature,
+ * so bus time is used by sensors with changing temperature
+ * @note not thread-safe, add and poll from same thread
+ * @note added bus is claimed, not used by pipeline, sampler or other fleet
+ */
+class c_ds18b20_fleet
+{
+public:
+    /**
+     * @brief class constuctor
+     * @param min_ns min. sample interval in ns
+     * @param max_ns max. sample interval in ns
+     * @param delta change of temp. between samples, interval is delta / rate of change
+     */
+    c_ds18b20_fleet(int64_t min_ns = FLEET_MIN_NS, int64_t max_ns = FLEET_MAX_NS, double delta = FLEET_DELTA)
+    {
+        m_min = min_ns;
+        m_max = max(max_ns, min_ns);
+        m_delta = delta;
+        m_reads = 0;
+        m_stop = false;
+    }
+
+    /**
+     * @brief releases buses on destroy
+     */
+    ~c_ds18b20_fleet()
+    {
+        for (fleet_bus& b: m_buses)
+            b.bus->detach(this);
+    }
+
+    /**
+     * @brief sets result callback
+     * @param callback called for each sensor read in poll()
+     */
+    void set_callback(ds18b20_fleet_callback callback)
+    {
+        m_callback = callback;
+    }
+
+    /**
+     * @brief adds sensors of bus
+     * @param bus ds18b20 bus
+     * @param idlist list with 64bit id's
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param repeat number of reads attemps 1..
+     * @returns false if no bus, no sensor in idlist or bus already added or used by other driver, bus is not added
+     * @note first read of sensors is due at once, add buses before run()
+     */
+    bool add(c_ds18b20* bus, const vector<sensor_id>& idlist, bool fh = false, uint8_t repeat = 10)
+    {
+        // bus without sensors has no deadline
+        if ((bus == NULL) || idlist.empty())
+            return false;
+
+        // one conversion state per bus
+        for (fleet_bus& b: m_buses)
+            if (b.bus == bus)
+                return false;
+
+        if (!bus->attach(this))
+            return false;
+
+        fleet_bus b;
+
+        b.bus = bus;
+        b.fh = fh;
+        b.repeat = repeat;
+        b.converting = false;
+        b.grouped = false;
+        b.start_ns = 0;
+        b.ready_ns = 0;
+
+        int64_t now = c_timer::now();
+
+        for (sensor_id id: idlist)
+        {
+            fleet_sensor s;
+
+            s.id = id;
+            s.interval = m_min;
+            s.next = now;
+            s.temp = INV_TEMP;
+            s.time = 0;
+            s.rate = 0.0;
+
+            b.sensors.push_back(s);
+        }
+
+        m_buses.push_back(move(b));
+
+        return true;
+    }
+
+    /**
+     * @brief runs due steps on all buses, does not wait
+     * @returns time of next step (c_timer::now), 0: no sensors
+     */
+    int64_t poll()
+    {
+        int64_t next = 0;
+
+        // buses with earliest deadline first
+        order();
+
+        for (size_t idx: m_order)
+        {
+            fleet_bus& b = m_buses[idx];
+
+            int64_t now = c_timer::now();
+
+            if (!b.converting)
+            {
+                int64_t convert_ns = b.bus->get_convert_ns();
 
-            // read sensor pad
-            memset(&pad, 0, sizeof(pad));
-            write_byte(READ_PAD);
-            read_block((uint8_t*) &pad, 9);
-    
-            // check crc, on mismatch continue read
-            if (crc8((uint8_t*) &pad, 8) != pad[8])
+                // sensors with deadline before conversion is done
+                b.due.clear();
+                b.ids.clear();
+
+                for (size_t i = 0; i < b.sensors.size(); i++)
+                {
+                    if (b.sensors[i].next <= now + convert_ns)
+                    {
+                        b.due.push_back(i);
+                        b.ids.push_back(b.sensors[i].id);
+                    }
+                }
+
+                // start conversion at deadline - conversion time
+                if (b.due.empty())
+                {
+                    next = earliest(next, deadline(b) - convert_ns);
+                    continue;
+                }
+
+                b.grouped = b.bus->is_grouped();
+                b.start_ns = now;
+
+                if (!b.bus->start_conversion(b.ready_ns, b.ids))
+                {
+                    b.templist.assign(b.due.size(), INV_TEMP);
+                    done(b, false);
+                    next = earliest(next, deadline(b) - convert_ns);
+                    continue;
+                }
+
+                b.converting = true;
+            }
+
+            // conversion not done, polls bus if enabled, groups use fixed wait
+            if (b.grouped ? (now < b.ready_ns) : !b.bus->conversion_done())
+            {
+                next = earliest(next, b.grouped ? b.ready_ns : b.bus->get_check_ns());
                 continue;
-    
-            // set convert parameter
-            u_temp.CHAR[0] = pad[0];
-            u_temp.CHAR[1] = pad[1];
-    
-            // convert to °C
-            temp =  0.0625 * (double)u_temp.SHORT;
-    
-            return true;
+            }
+
+            // collect results
+            bool ok = b.bus->collect(b.ids, b.fh, b.templist, b.repeat);
+
+            b.converting = false;
+            done(b, ok);
+
+            // start next conversion of bus now
+            next = earliest(next, c_timer::now());
         }
-    
-        return print_error("ds18b20: no sensor read");
+
+        return next;
     }
 
     /**
-     * @brief get bit of 64bit id
-     * @param id 64 bit sensor id 
-     * @param bit bit position 
-     * @returns bit value
+     * @brief runs scheduler until stop() is called
+     * @note blocks current thread
      */
-    int8_t idgetbit(sensor_id& id, int8_t bit)
+    void run()
     {
-        sensor_id mask = 1ULL << bit;
-    
-        return ((id & mask) ? 1 : 0);
+        int64_t next;
+
+        m_stop = false;
+
+        while (!m_stop && ((next = poll()) != 0))
+            m_timer.sleep_until(next);
     }
-    
+
     /**
-     * @brief set bit on 64bit id
-     * @param id 64 bit sensor id 
-     * @param bit bit position 
-     * @param bitval bit value to set 
-     * @returns id changed id
+     * @brief stops run() after actual step
      */
-    sensor_id idsetbit(sensor_id& id, int8_t bit, uint8_t bitval)
+    void stop()
     {
-        sensor_id mask = 1ULL << bit;
-    
-        if((bit >= 0) && (bit < 64))
-        {
-            if (bitval == 0)
-                id &= ~mask;
-            else
-                id |= mask;
-        }
-    
-        return id;
+        m_stop = true;
     }
 
     /**
-     * @brief scan for sensors
-     * @param id 64 bit sensor id 
-     * @param lastbit bit position 
-     * @returns -2: repeat, -1: error, 0: no more sensors, 1: sensor found
+     * @brief returns actual sample interval of sensor
+     * @param id 64 bit sensor id
+     * @param interval_ns receives interval in ns
+     * @returns false if sensor not in scheduler
      */
-    int8_t search_sensor(sensor_id& id, int8_t& lastbit)
+    bool get_interval(const sensor_id& id, int64_t& interval_ns)
     {
-        c_priority priority;
-    
-        // check lastbit and report no more id's
-        if (lastbit < 0)
-            return 0;
-    
-        // set bit in id and reset remaining id bits
-        if (lastbit < 64)
-        {
-            idsetbit(id, lastbit, 1);
-    
-            for (int32_t idx = lastbit + 1; idx < 64; idx++)
-                idsetbit(id, idx, 0);
-        }
-    
-        lastbit = -1;
-    
-        // resets 1-wire bus
-        if (!reset())
-            return -1; // return error
-    
-        write_byte(SEARCH_ROM);
-    
-        // examine 64bit stream
-        for (int8_t idx=0; idx < 64; idx++)
+        for (fleet_bus& b: m_buses)
         {
-            // read bits in sequence
-            uint8_t nobit = read_bit();
-            uint8_t bit = read_bit();
-    
-            // check for bit mismatch
-            if (bit && nobit)
-                return -2; // report bit mismatch -> repeat
-    
-            // check bits
-            if (!bit && !nobit) 
+            for (fleet_sensor& s: b.sensors)
             {
-                if (idgetbit(id, idx))
-                    write_bit(1);
-                else
+                if (s.id == id)
                 {
-                    lastbit = idx;
-                    write_bit(0);
+                    interval_ns = s.interval;
+                    return true;
                 }
             }
-            else if (!bit) // it is a 1
-            {
-                write_bit(1);
-                idsetbit(id, idx, 1);
-            }
-            else // it is a 0
-            {
-                write_bit(0);
-                idsetbit(id, idx, 0);
-            }
         }
-    
-        return 1; // valid id found
+
+        return false;
     }
 
     /**
-     * @brief read on bit from 1-wire bus
-     * @returns byte value
+     * @brief returns count of sensor reads
      */
-    uint8_t read_bit()
+    uint64_t get_reads() { return m_reads; }
+
+private:
+    // sensor of scheduler
+    struct fleet_sensor {
+        sensor_id id;     // 64bit id
+        int64_t interval; // actual sample interval
+        int64_t next;     // deadline of next read
+        double temp;      // last valid temperature
+        int64_t time;     // time of last valid temperature
+        double rate;      // smoothed rate of change per s
+    };
+
+    // bus of scheduler
+    struct fleet_bus {
+        c_ds18b20* bus;               // ds18b20 bus
+        vector<fleet_sensor> sensors; // sensors of bus
+        vector<size_t> due;           // index of sensors in conversion
+        vector<sensor_id> ids;        // id's of sensors in conversion
+        vector<double> templist;      // temperatures read
+        bool fh;                      // fahrenheit flag
+        uint8_t repeat;               // number of reads attemps
+        bool converting;              // conversion started
+        bool grouped;                 // only sensors in conversion convert
+        int64_t start_ns;             // conversion start time
+        int64_t ready_ns;             // conversion done time
+    };
+
+    // returns earlier time, 0: no time
+    static int64_t earliest(int64_t a, int64_t b)
     {
-        int8_t bit;
-        set_low();
-        m_timer.delay_us(1l);
-        set_high();
-        m_timer.delay_us(2l);
-        bit = read();
-        m_timer.delay_us(60l);
-        return bit;
+        return ((a == 0) || (b < a)) ? b : a;
     }
-            
+
+    // returns earliest deadline of bus
+    static int64_t deadline(const fleet_bus& b)
+    {
+        if (b.converting)
+            return b.ready_ns;
+
+        int64_t t = 0;
+
+        for (const fleet_sensor& s: b.sensors)
+            t = earliest(t, s.next);
+
+        return t;
+    }
+
+    // sorts buses by deadline
+    void order()
+    {
+        m_order.resize(m_buses.size());
+        m_deadline.resize(m_buses.size());
+
+        for (size_t i = 0; i < m_buses.size(); i++)
+        {
+            m_order[i] = i;
+            m_deadline[i] = deadline(m_buses[i]);
+        }
+
+        sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) { return m_deadline[a] < m_deadline[b]; });
+    }
+
     /**
-     * @brief read one byte from 1-wire bus
-     * @returns byte value
+     * @brief updates sensors of conversion and reports results
+     * @param b bus
+     * @param ok false: read of bus failed
      */
-    uint8_t read_byte()
+    void done(fleet_bus& b, bool ok)
     {
-        uint8_t byte = 0;
-    
-        for (uint8_t i=0; i<8; i++)
+        int64_t now = c_timer::now();
+
+        for (size_t k = 0; k < b.due.size(); k++)
         {
-            set_low();
-            m_timer.delay_us(1l);
-            set_high();
-            m_timer.delay_us(2l);
-    
-            if (read())
-                byte |= (1 << i);
-    
-            m_timer.delay_us(60l);
+            fleet_sensor& s = b.sensors[b.due[k]];
+
+            double temp = (ok && (k < b.templist.size())) ? b.templist[k] : INV_TEMP;
+
+            if (temp != INV_TEMP)
+                adapt(s, temp, b.start_ns);
+
+            s.next = now + s.interval;
+            m_reads++;
+
+            if (m_callback)
+                m_callback(b.bus, s.id, temp != INV_TEMP, temp);
         }
-    
-        return byte;
     }
-    
+
+    /**
+     * @brief adapts sample interval to rate of change
+     * @param s sensor
+     * @param temp temperature read
+     * @param time_ns time of temperature
+     */
+    void adapt(fleet_sensor& s, double temp, int64_t time_ns)
+    {
+        if ((s.time != 0) && (time_ns > s.time))
+        {
+            double rate = fabs(temp - s.temp) * 1e9 / (double) (time_ns - s.time);
+
+            // smoothed, one step of noise does not halve interval
+            s.rate = (s.rate + rate) / 2.0;
+
+            double interval = (s.rate > 0.0) ? (m_delta / s.rate * 1e9) : (double) m_max;
+
+            s.interval = (int64_t) min(max(interval, (double) m_min), (double) m_max);
+        }
+
+        s.temp = temp;
+        s.time = time_ns;
+    }
+
+    vector<fleet_bus> m_buses;        // buses of scheduler
+    vector<size_t> m_order;           // bus index by deadline
+    vector<int64_t> m_deadline;       // deadline of buses
+    int64_t m_min;                    // min. sample interval
+    int64_t m_max;                    // max. sample interval
+    double m_delta;                   // change of temp. between samples
+    uint64_t m_reads;                 // count of sensor reads
+    ds18b20_fleet_callback m_callback; // result callback
+    atomic_bool m_stop;               // stop flag
+    c_timer m_timer;                  // used for sleep
+};
+
+/**
+ * @brief class c_ds18b20_multi
+ *
+ * ds18b20 on up to 64 buses, 1-wire slots run on all buses at same time,
+ * scan and read of many buses takes about time of one bus
+ */
+class c_ds18b20_multi
+{
+public:
     /**
-     * @brief read multiple bytes from 1-wire bus
-     * @param data points to data to receive
-     * @param len length of data
+     * @brief class constuctor
      */
-    void read_block(uint8_t* data, uint8_t len)
+    c_ds18b20_multi()
     {
-        for (uint8_t i=0; i<len; i++)
-            data[i] = read_byte();
+        m_res = RES_SENSOR_12;
     }
 
     /**
-     * @brief write one bit to 1-wire bus
-     * @param bit data to write
+     * @brief returns message buffer
+     * @returns message
      */
-    void write_bit(uint8_t bit)
+    const char* get_error()
     {
-        set_low();
-    
-        if (bit)
+        return m_bus.get_error();
+    }
+
+    /**
+     * @brief inits bus gpio pins
+     * @param chip pointer to chip
+     * @param pins bus pins (0..27), one bus on each pin
+     * @param print_msg flag for print error messages, true = on
+     * @returns true: ok, false: error
+     */
+    bool init(c_chip* chip, const vector<uint32_t>& pins, bool print_msg = false)
+    {
+        return m_bus.init(chip, pins.data(), pins.size(), print_msg);
+    }
+
+    /**
+     * @brief returns count of buses
+     */
+    uint32_t get_count() { return m_bus.get_count(); }
+
+    /**
+     * @brief returns 1-wire buses
+     */
+    c_onewire_multi& bus() { return m_bus; }
+
+    /**
+     * @brief set resolution on all sensors on all buses
+     * @param res sensor resolution RES_SENSOR_..
+     * @returns false if no sensor on any bus or error
+     * @note overwrites alarm window of all sensors with TH 127°C and TL -128°C (never alarm)
+     */
+    bool set_resolution(uint32_t res)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        m_bus.clear_error();
+
         {
-            m_timer.delay_us(1l);
-            set_high();
-            m_timer.delay_us(60l);
+            c_ow_transaction ta(m_bus);
+
+            // write resolution to sensors on all buses
+            uint64_t mask = select(NULL, m_bus.get_mask());
+
+            if (mask == 0)
+                return false;
+
+            m_bus.write_byte(WRITE_PAD, mask);
+            m_bus.write_byte(0x7F, mask); // TH 127°C, never alarm
+            m_bus.write_byte(0x80, mask); // TL -128°C, never alarm
+            m_bus.write_byte(c_ds18b20::res_cfg(res), mask); // resolution
         }
-        else
+
+        m_timer.sleep_ms(1);
+        m_res = res;
+
+        return true;
+    }
+
+    /**
+     * @brief scan for sensors on all buses at same time
+     * @param idlists idlists[n] receives 64bit id's of n-th bus
+     * @param repeat number of scan attemps 1..
+     * @returns true: ok, false: error
+     */
+    bool scan_sensor(vector<vector<sensor_id>>& idlists, uint8_t repeat = 10)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        m_bus.clear_error();
+
+        uint32_t count = m_bus.get_count();
+
+        sensor_id id[GPIO_V2_LINES_MAX], _id[GPIO_V2_LINES_MAX];
+        int8_t nextbit[GPIO_V2_LINES_MAX], _nextbit[GPIO_V2_LINES_MAX];
+        int8_t result[GPIO_V2_LINES_MAX];
+        uint8_t r[GPIO_V2_LINES_MAX];
+
+        // clear id lists
+        idlists.assign(count, vector<sensor_id>());
+
+        for (uint32_t n = 0; n < count; n++)
         {
-            m_timer.delay_us(60l);
-            set_high();
-            m_timer.delay_us(1l);
+            id[n] = 0ULL;
+            nextbit[n] = 64;
+            r[n] = 0;
         }
-    
-        m_timer.delay_us(60l);
+
+        uint64_t mask = m_bus.get_mask();
+
+        // repeated scan of buses with more sensors
+        while (mask != 0)
+        {
+            for (uint32_t n = 0; n < count; n++)
+            {
+                _id[n] = id[n];
+                _nextbit[n] = nextbit[n];
+            }
+
+            {
+                c_ow_transaction ta(m_bus);
+
+                // search all buses for sensors
+                m_bus.search(OW_SEARCH_ROM, _id, _nextbit, result, mask);
+            }
+
+            if (*m_bus.get_error() != 0)
+                return false;
+
+            for (uint32_t n = 0; n < count; n++)
+            {
+                if (!(mask & (1ULL << n)))
+                    continue;
+
+                switch(result[n])
+                {
+                    case -1: // no sensor on bus
+                    case 0: // no more sensors
+                        mask &= ~(1ULL << n);
+                        continue;
+                    case 1: // id found
+                        // check crc
+                        if ((_id[n] >> 56) == c_onewire::crc8((uint8_t*) &_id[n], 7))
+                        {
+                            r[n] = 0; // reset repeat
+                            id[n] = _id[n];
+                            nextbit[n] = _nextbit[n];
+
+                            // save id in list
+                            idlists[n].push_back(id[n]);
+                            continue;
+                        }
+                        break;
+                    default: // repeat search
+                        break;
+                }
+
+                // end scan on bus after repeat attemps
+                if (++r[n] >= repeat)
+                    mask &= ~(1ULL << n);
+            }
+        }
+
+        return true;
     }
-        
+
     /**
-     * @brief write one byte to 1-wire bus
-     * @param byte data to write
+     * @brief read sensors from id lists on all buses at same time
+     * @param idlists idlists[n] is list with 64bit id's of n-th bus
+     * @param fh fh true for fahrenheit, false for celsius
+     * @param templists templists[n] receives temperatures of n-th bus
+     * @param repeat number of reads attemps 1..
+     * @returns false if no sensor on any bus or error
+     * @note if error on read of one sensor, list are marked with INV_TEMP
+     * @note waits conversion without lock, other calls are not blocked
      */
-    void write_byte(uint8_t byte)
+    bool read_sensors(vector<vector<sensor_id>>& idlists, bool fh, vector<vector<double>>& templists, uint8_t repeat = 10)
     {
-        for (uint8_t i=0; i<8; i++)
+        uint32_t count;
+        uint32_t res;
+
+        {
+            const lock_guard<mutex> lock(m_mtx);
+
+            // clear error
+            m_bus.clear_error();
+
+            count = m_bus.get_count();
+
+            if (idlists.size() != count)
+                return m_bus.print_error("ds18b20: invalid id list");
+
+            // send start sensor conversion on all buses
+            c_ow_transaction ta(m_bus);
+
+            uint64_t mask = select(NULL, m_bus.get_mask());
+
+            if (mask == 0)
+                return false;
+
+            m_bus.write_byte(COVERT_T, mask);
+
+            res = m_res;
+        }
+
+        // wait depends on sensor resolution
+        m_timer.sleep_ns(c_ds18b20::get_convert_ns(res));
+
+        const lock_guard<mutex> lock(m_mtx);
+
+        // mark all temperatures invalid
+        templists.resize(count);
+
+        size_t nmax = 0;
+
+        for (uint32_t n = 0; n < count; n++)
+        {
+            templists[n].assign(idlists[n].size(), INV_TEMP);
+            nmax = max(nmax, idlists[n].size());
+        }
+
+        sensor_id ids[GPIO_V2_LINES_MAX];
+        uint8_t pads[GPIO_V2_LINES_MAX * 9];
+
+        // read i-th sensor of all buses at same time
+        for (size_t i = 0; i < nmax; i++)
         {
-            set_low();
-                
-            if (byte & (1 << i)) // write high bit
+            uint64_t mask = 0;
+
+            for (uint32_t n = 0; n < count; n++)
             {
-                m_timer.delay_us(1l);
-                set_high();
-                m_timer.delay_us(60l);
+                if (i < idlists[n].size())
+                {
+                    ids[n] = idlists[n][i];
+                    mask |= 1ULL << n;
+                }
             }
-            else // write low bit
+
+            // read repeated on buses with invalid read
+            for (uint8_t r = 0; (r < repeat) && (mask != 0); r++)
             {
-                m_timer.delay_us(60l);
-                set_high();
-                m_timer.delay_us(1l);
+                c_ow_transaction ta(m_bus);
+
+                // reset buses and send match rom
+                uint64_t present = select(ids, mask);
+
+                if (present == 0)
+                    break;
+
+                // read sensor pad
+                m_bus.write_byte(READ_PAD, present);
+                m_bus.read_block(pads, 9, present);
+
+                for (uint32_t n = 0; n < count; n++)
+                {
+                    if (!(present & (1ULL << n)))
+                        continue;
+
+                    uint8_t* pad = pads + n * 9;
+
+                    // check crc, on mismatch continue read
+                    if (c_onewire::crc8(pad, 8) != pad[8])
+                        continue;
+
+                    // convert to °C
+                    double temp = 0.0625 * (double)(int16_t)(pad[0] | (pad[1] << 8));
+
+                    // convert to fahrenheit
+                    if (fh)
+                        temp = temp * (9.0/5.0) + 32.0;
+
+                    templists[n][i] = temp;
+                    mask &= ~(1ULL << n);
+                }
             }
-    
-            m_timer.delay_us(60l);
         }
-    
-        m_timer.delay_us(100l);
+
+        return true;
     }
-    
+
+private:
+    // sensor command codes
+    enum {
+        COVERT_T   = 0x44,
+        WRITE_PAD  = 0x4E,
+        READ_PAD   = 0xBE
+    };
+
     /**
-     * @brief write multiple bytes to 1-wire bus
-     * @param data points to data to send
-     * @param len length of data
+     * @brief resets buses and selects sensors
+     * @param ids ids[n] is 64 bit sensor id of n-th bus, NULL: all sensors
+     * @param mask selected buses
+     * @returns mask of buses with sensors, 0: no sensor or error
      */
-    void write_block(const uint8_t* data, uint8_t len)
+    uint64_t select(const sensor_id* ids, uint64_t mask)
     {
-        for (uint8_t i=0; i<len; i++)
-            write_byte(data[i]);
-    }
+        mask = m_bus.select(ids, mask);
 
-    // gpio functions wrapper
-    inline bool set_low()  { return m_gpio.write(0); }
-    inline bool set_high() { return m_gpio.write(1); }
-    inline uint8_t read()  { return m_gpio.read(); }
+        // gpio error has message
+        if ((mask == 0) && (*m_bus.get_error() == 0))
+            m_bus.print_error("ds18b20: no sensor");
 
-    c_gpio m_gpio;    // sensor gpio
-    c_timer m_timer;  // used for delay and sleep
-    uint32_t m_res;   // saved resolution
-    mutex m_mtx;      // lock mutex
+        return mask;
+    }
+
+    c_onewire_multi m_bus; // 1-wire buses
+    c_timer m_timer;       // used for sleep
+    uint32_t m_res;        // saved resolution
+    mutex m_mtx;           // lock mutex
 };
@@ -0,0 +1,93 @@
+/*
+ * example reads ds18b20 sensors on many buses with adaptive sampling
+ *
+ * connect ds18b20 data pins to gpio pin 21, 20 and 16
+ * connect pullup resistor between each pin and +3.3v
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./fleet
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_RES RES_SENSOR_12 // sensor resolution
+#define MIN_INTERVAL 1000000000l // min. sample interval 1s in ns
+#define MAX_INTERVAL 30000000000l // max. sample interval 30s in ns
+#define DELTA 0.25 // change of temp. between samples
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+#define POLL_CONVERT true // poll conversion complete, not on parasite power
+
+// gpio pins of buses
+const vector<uint32_t> pins = { 21, 20, 16 };
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver of each bus
+vector<c_ds18b20> buses(pins.size());
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** ds18b20 fleet scheduler C++ example ***");
+
+    // scheduler for all buses
+    c_ds18b20_fleet fleet(MIN_INTERVAL, MAX_INTERVAL, DELTA);
+
+    for (size_t i = 0; i < pins.size(); i++)
+    {
+        vector<sensor_id> idlist;
+
+        if (!buses[i].init(&chip, pins[i], PRINT_MSG))
+            return 1;
+
+        // bus without sensors is skipped
+        if (!buses[i].scan_sensor(idlist) || !fleet.add(&buses[i], idlist, FAHRENHEIT))
+        {
+            printf("no sensor on pin %u\n", pins[i]);
+            continue;
+        }
+
+        if (!buses[i].set_resolution(SENSOR_RES))
+            return 1;
+
+        // conversion done earlier than fixed wait
+        if (!buses[i].set_poll_convert(POLL_CONVERT))
+            return 1;
+    }
+
+    // print each read with actual interval
+    fleet.set_callback([&fleet](c_ds18b20* bus, const sensor_id& id, bool ok, double temp)
+    {
+        sensor_id sid = id;
+        string s_id;
+        int64_t interval;
+
+        if (!ok || !bus->idtostr(sid, s_id) || !fleet.get_interval(id, interval))
+            return;
+
+        printf("%s temperature: %.2f°C interval: %llds\n", s_id.c_str(), temp, (long long) (interval / 1000000000));
+    });
+
+    // read until program is stopped
+    fleet.run();
+
+    return 0;
+}
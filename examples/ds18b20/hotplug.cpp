@@ -0,0 +1,109 @@
+/*
+ * example detects added and removed ds18b20 sensors while reading
+ *
+ * connect ds18b20 data pin to gpio pin 21
+ * connect pullup resistor between pin 21 and +3.3v    
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./hotplug
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_PIN 21 // gpio pin for ds18b20
+#define SENSOR_RES RES_SENSOR_9 // sensor resolution
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+#define DISCOVER_STEPS 2 // rom search steps on each discover
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver
+c_ds18b20 ds18b20;
+
+// known sensors
+vector<sensor_id> idlist;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+// prints id's with text
+void print_ids(const char* text, vector<sensor_id>& ids)
+{
+    string s_id;
+
+    for (sensor_id id: ids)
+        if (ds18b20.idtostr(id, s_id))
+            printf("%s %s\n", text, s_id.c_str());
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** ds18b20 hot-plug C++ example ***");
+
+    // create timer
+    c_timer timer;
+
+    // init ds18b20
+    if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
+        return 1;
+    
+    // scan for sensors on 1-wire bus
+    if (!ds18b20.scan_sensor(idlist))
+        return 1;
+
+    print_ids("found", idlist);
+
+    // alarm window of set_resolution never alarms
+    ds18b20.set_resolution(SENSOR_RES);
+
+    // read loop
+    while(1)
+    {
+        vector<sensor_id> added, removed;
+
+        // few search steps, tree walk continues on next call
+        if (!ds18b20.discover(idlist, added, removed, DISCOVER_STEPS))
+            return 1;
+
+        print_ids("added", added);
+        print_ids("removed", removed);
+
+        // new sensors get resolution, alarm window of all sensors is overwritten
+        if (added.size() > 0)
+            ds18b20.set_resolution(SENSOR_RES);
+
+        // list of temperature
+        vector<double> templist;
+
+        if (!ds18b20.read_sensors(idlist, FAHRENHEIT, templist))
+            puts("no sensor on bus");
+
+        puts("------------------------");
+        
+        // print all temperatures
+        for (double temp: templist)
+            if (temp != INV_TEMP)
+                printf("temperature: %.1f°C\n", temp);
+        
+        // sleep 3s
+        timer.sleep_s(3);
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * example reads ds18b20 sensors on two buses with conversion pipeline
+ *
+ * connect ds18b20 data pins to gpio pin 21 and 20
+ * connect pullup resistor between each pin and +3.3v    
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./read_async
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_PIN1 21 // gpio pin of bus 1
+#define SENSOR_PIN2 20 // gpio pin of bus 2
+#define SENSOR_RES RES_SENSOR_9 // sensor resolution
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+#define POLL_CONVERT true // poll conversion complete, not on parasite power
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver of each bus
+c_ds18b20 bus1, bus2;
+
+// idlist of each bus
+vector<sensor_id> idlist1, idlist2;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+// init bus, scan sensors and set resolution
+bool init_bus(c_ds18b20& bus, uint32_t pin, vector<sensor_id>& idlist)
+{
+    if (!bus.init(&chip, pin, PRINT_MSG))
+        return false;
+
+    if (!bus.scan_sensor(idlist))
+        return false;
+
+    if (!bus.set_resolution(SENSOR_RES))
+        return false;
+
+    // conversion done earlier than fixed wait
+    return bus.set_poll_convert(POLL_CONVERT);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** ds18b20 conversion pipeline C++ example ***");
+
+    // create timer
+    c_timer timer;
+
+    if (!init_bus(bus1, SENSOR_PIN1, idlist1) || !init_bus(bus2, SENSOR_PIN2, idlist2))
+        return 1;
+
+    // conversion pipeline
+    c_ds18b20_pipeline pipeline;
+
+    // read loop
+    while(1)
+    {
+        // result of bus 1 with callback
+        pipeline.add(&bus1, idlist1, FAHRENHEIT, [](bool ok, vector<double>& templist)
+        {
+            for (double temp: templist)
+                if (ok && (temp != INV_TEMP))
+                    printf("bus 1 temperature: %.1f°C\n", temp);
+        });
+
+        // result of bus 2 with future
+        future<vector<double>> result2 = pipeline.add(&bus2, idlist2, FAHRENHEIT);
+
+        // both buses convert at same time
+        pipeline.run();
+
+        for (double temp: result2.get())
+            if (temp != INV_TEMP)
+                printf("bus 2 temperature: %.1f°C\n", temp);
+
+        puts("------------------------");
+
+        // sleep 3s
+        timer.sleep_s(3);
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * example scans and reads ds18b20 sensors on multiple buses at same time
+ *
+ * connect ds18b20 data pins to gpio pins 21, 20, 16 and 12
+ * connect pullup resistor between each pin and +3.3v    
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./read_buses
+ *
+ */
+
+#include <stdio.h>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_RES RES_SENSOR_9 // sensor resolution
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+
+// gpio pins of buses
+vector<uint32_t> pins = { 21, 20, 16, 12 };
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver for all buses
+c_ds18b20_multi ds18b20;
+
+// idlist of each bus
+vector<vector<sensor_id>> idlists;
+
+// list of temperature of each bus
+vector<vector<double>> templists;
+
+int main()
+{
+    puts("*** ds18b20 multi bus C++ example ***");
+
+    // create timer
+    c_timer timer;
+
+    // init ds18b20 buses
+    if (!ds18b20.init(&chip, pins, PRINT_MSG))
+        return 1;
+    
+    // scan for sensors on all buses
+    int64_t start = timer.now();
+
+    if (!ds18b20.scan_sensor(idlists))
+        return 1;
+
+    printf("scan time: %.1fms\n", double(timer.now() - start) / 1e6);
+
+    // set sensor resolution
+    if (!ds18b20.set_resolution(SENSOR_RES))
+        return 1;
+
+    // read ds18b20 sensors on all buses
+    if (!ds18b20.read_sensors(idlists, FAHRENHEIT, templists))
+        return 1;
+
+    // print all temperatures
+    for (uint32_t n = 0; n < templists.size(); n++)
+        for (double temp: templists[n])
+            if (temp == INV_TEMP)
+                printf("pin %d: not read\n", pins[n]);
+            else
+                printf("pin %d: temperature: %.1f°C\n", pins[n], temp);
+
+    printf("bus throughput: %.0f bits/s\n", ds18b20.bus().get_bits_per_sec());
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * example reads ds18b20 sensor groups with different resolution on one bus
+ *
+ * connect ds18b20 data pins to gpio pin 21
+ * connect pullup resistor between pin and +3.3v
+ * sensors must have external power (no parasite power)
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./read_groups
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_PIN 21 // gpio pin of bus
+#define PROCESS_SENSORS 1 // first sensors on bus are process sensors
+#define PROCESS_RES RES_SENSOR_12 // resolution of process sensors
+#define AMBIENT_RES RES_SENSOR_9 // resolution of other sensors
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver
+c_ds18b20 ds18b20;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** ds18b20 sensor groups C++ example ***");
+
+    if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
+        return 1;
+
+    vector<sensor_id> idlist;
+
+    if (!ds18b20.scan_sensor(idlist))
+        return 1;
+
+    // set resolution of each sensor on each start, pad only, no eeprom write
+    for (size_t i = 0; i < idlist.size(); i++)
+        if (!ds18b20.set_config(idlist[i], (i < PROCESS_SENSORS) ? PROCESS_RES : AMBIENT_RES))
+            return 1;
+
+    vector<vector<sensor_id>> groups;
+
+    ds18b20.group_resolution(idlist, groups);
+
+    // conversion pipeline
+    c_ds18b20_pipeline pipeline;
+
+    // create timer
+    c_timer timer;
+
+    // request is running for group
+    vector<bool> running(groups.size(), false);
+
+    // read loop, each group at rate of its resolution
+    while(1)
+    {
+        for (uint32_t res = 0; res < groups.size(); res++)
+        {
+            if (groups[res].empty() || running[res])
+                continue;
+
+            running[res] = true;
+
+            pipeline.add(&ds18b20, groups[res], FAHRENHEIT, [res, &running](bool ok, vector<double>& templist)
+            {
+                running[res] = false;
+
+                for (double temp: templist)
+                    if (ok && (temp != INV_TEMP))
+                        printf("%ubit temperature: %.2f°C\n", res + 9, temp);
+            });
+        }
+
+        timer.sleep_until(pipeline.poll());
+    }
+
+    return 0;
+}
@@ -28,6 +28,7 @@
 #define FAHRENHEIT false // temp. in °C
 
 #define PRINT_MSG true // print error on console
+#define RT_CPU RT_CPU_ISOLATED // pin to isolated cpu if any
 
 // only one chip
 c_chip chip;
@@ -60,6 +61,12 @@ int main()
     // create timer
     c_timer timer;
 
+    // enter real time context once, no priority switch on each bus access
+    c_rt_context rt(RT_CPU);
+
+    if (!rt.enter())
+        puts("real time context not complete, run as root");
+
     // init ds18b20
     if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
         return 1;
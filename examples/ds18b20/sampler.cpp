@@ -0,0 +1,97 @@
+/*
+ * example reads latest ds18b20 values of background sampler
+ *
+ * connect ds18b20 data pins to gpio pin 21
+ * connect pullup resistor between pin and +3.3v
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./sampler
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_ds18b20.h"
+
+#define SENSOR_PIN 21 // gpio pin of bus
+#define SENSOR_RES RES_SENSOR_12 // sensor resolution
+#define SAMPLE_PERIOD 2000000000l // sample period 2s in ns
+#define FAHRENHEIT false // temp. in °C
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// ds18b20 driver
+c_ds18b20 ds18b20;
+
+// background sampler
+c_ds18b20_sampler sampler;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** ds18b20 background sampler C++ example ***");
+
+    if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
+        return 1;
+
+    vector<sensor_id> idlist;
+
+    if (!ds18b20.scan_sensor(idlist))
+        return 1;
+
+    if (!ds18b20.set_resolution(SENSOR_RES))
+        return 1;
+
+    // sample all sensors in background
+    if (!sampler.start(&ds18b20, idlist, SAMPLE_PERIOD, FAHRENHEIT))
+        return 1;
+
+    // create timer
+    c_timer timer;
+
+    vector<ds18b20_sample> samples;
+    string s_id;
+
+    // read loop, no wait for conversion
+    while(1)
+    {
+        sampler.get_all(samples);
+
+        int64_t now = c_timer::now();
+
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            ds18b20.idtostr(idlist[i], s_id);
+
+            if (samples[i].quality & SAMPLE_NONE)
+                printf("%s no value\n", s_id.c_str());
+            else
+                printf("%s temperature: %.2f°C age: %lldms%s%s\n", s_id.c_str(), samples[i].temp,
+                    (long long) ((now - samples[i].time_ns) / 1000000),
+                    (samples[i].quality & SAMPLE_ERROR) ? " error" : "",
+                    (samples[i].quality & SAMPLE_STALE) ? " stale" : "");
+        }
+
+        puts("------------------------");
+
+        // sleep 1s
+        timer.sleep_s(1);
+    }
+
+    return 0;
+}
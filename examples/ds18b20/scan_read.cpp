@@ -20,6 +20,7 @@
 #define SENSOR_RES RES_SENSOR_9 // sensor resolution
 #define FAHRENHEIT false // temp. in °C
 #define PRINT_MSG true // print error on console
+#define ID_CACHE "ds18b20_21.ids" // sensor id cache file
 
 // only one chip
 c_chip chip;
@@ -44,8 +45,8 @@ int main()
     if (!ds18b20.init(&chip, SENSOR_PIN, PRINT_MSG))
         return 1;
     
-    // scan for sensors on 1-wire bus
-    if (!ds18b20.scan_sensor(idlist))
+    // verify cached sensors, scan 1-wire bus only on failure
+    if (!ds18b20.scan_sensor(ID_CACHE, idlist))
         return 1;
 
     // check size
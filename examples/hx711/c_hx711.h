@@ -11,11 +11,15 @@
 
 #include <mutex>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <vector>
 using namespace std;
 
 #include "../../include/gpiox.h"
 #include "../../include/c_timer.h"
 #include "../../include/c_priority.h"
+#include "../../include/c_queue.h"
 
 /**
  * @brief gain and channel
@@ -26,36 +30,295 @@ enum {
     GAIN_A64 = 3,  // channel A gain 64
 };
 
+// max. time of clock high in ns, hx711 powers down after 60us
+#define HX711_HIGH_MAX_NS 50000l
+
+// reads of conversion if clock high was too long
+#define HX711_RETRY 3
+
+// max. wait time for ready in ms
+#define HX711_READY_MS 600
+
+// count of samples in stream queue (power of 2)
+#define HX711_STREAM_SIZE 1024
+
+// max. window of sliding mean and median
+#define HX711_FILTER_MAX 64
+
+// spikes in series accepted as step of load
+#define HX711_SPIKE_STEP 3
+
+// max. count of hx711 on shared clock
+#define HX711_MULTI_MAX 16
+
 /**
- * @brief class c_hx711
+ * @brief timing of raw reads
+ */
+struct hx711_timing {
+    uint64_t reads;      // count of raw reads
+    uint64_t over;       // raw reads with clock high > HX711_HIGH_MAX_NS
+    int64_t high_max_ns; // max. time of clock high
+    int64_t read_max_ns; // max. time of raw read
+};
+
+/**
+ * @brief sample of stream
  */
-class c_hx711
+struct hx711_sample {
+    int64_t time_ns; // time of ready, falling edge of dt (c_timer::now)
+    int32_t value;   // hx711 adc value
+    uint32_t seq;    // sequence number 1.., gaps are dropped samples
+};
+
+/**
+ * @brief filtered value of stream
+ */
+struct hx711_reading {
+    int64_t time_ns; // time of ready of last sample
+    double value;    // filter output
+    uint32_t seq;    // sequence number of last sample
+};
+
+/**
+ * @brief class c_hx711_filter
+ * @note streaming filter: spike rejection -> sliding median -> sliding mean -> iir,
+ *       each stage costs constant time per sample, not thread safe
+ */
+class c_hx711_filter
+{
+public:
+    /**
+     * @brief class constuctor, all stages off
+     */
+    c_hx711_filter()
+    {
+        set();
+    }
+
+    /**
+     * @brief sets filter stages and resets filter
+     * @param median window of sliding median, odd 1..HX711_FILTER_MAX, 1: off
+     * @param mean window of sliding mean 1..HX711_FILTER_MAX, 1: off
+     * @param alpha weight of new value in iir 0.0 < alpha <= 1.0, 1.0: off
+     * @param spike max. change to last accepted sample, 0: off
+     * @returns true: ok, false: invalid parameter
+     */
+    bool set(uint32_t median = 1, uint32_t mean = 1, double alpha = 1.0, uint32_t spike = 0)
+    {
+        if ((median == 0) || (median > HX711_FILTER_MAX) || ((median & 1) == 0))
+            return false;
+
+        if ((mean == 0) || (mean > HX711_FILTER_MAX))
+            return false;
+
+        if ((alpha <= 0.0) || (alpha > 1.0))
+            return false;
+
+        m_med_size = median;
+        m_mean_size = mean;
+        m_alpha = alpha;
+        m_spike = spike;
+
+        reset();
+
+        return true;
+    }
+
+    /**
+     * @brief clears filter state
+     */
+    void reset()
+    {
+        m_count = 0;
+        m_last = 0;
+        m_steps = 0;
+        m_spikes = 0;
+        m_med_count = 0;
+        m_med_pos = 0;
+        m_mean_count = 0;
+        m_mean_pos = 0;
+        m_sum = 0;
+        m_iir = 0.0;
+    }
+
+    /**
+     * @brief adds sample to filter
+     * @param value hx711 adc value
+     * @returns false: sample rejected as spike
+     */
+    bool add(int32_t value)
+    {
+        // reject spike, accept if in series (step of load)
+        if ((m_spike != 0) && (m_count != 0) && ((uint32_t) abs(int64_t(value) - m_last) > m_spike))
+        {
+            if (++m_steps < HX711_SPIKE_STEP)
+            {
+                m_spikes++;
+                return false;
+            }
+
+            // settle at once on new load
+            uint64_t spikes = m_spikes;
+            reset();
+            m_spikes = spikes;
+        }
+
+        m_steps = 0;
+        m_last = value;
+
+        int32_t med = median(value);
+
+        // sliding mean over sum of window
+        if (m_mean_count == m_mean_size)
+            m_sum -= m_mean[m_mean_pos];
+        else
+            m_mean_count++;
+
+        m_mean[m_mean_pos] = med;
+        m_sum += med;
+        m_mean_pos = (m_mean_pos + 1) % m_mean_size;
+
+        double mean = double(m_sum) / double(m_mean_count);
+
+        // iir starts with first value
+        m_iir = (m_count == 0) ? mean : m_iir + m_alpha * (mean - m_iir);
+
+        m_count++;
+
+        return true;
+    }
+
+    /**
+     * @brief returns filter output
+     * @param value receives filter output
+     * @returns false: no sample yet
+     */
+    bool get(double& value)
+    {
+        if (m_count == 0)
+            return false;
+
+        value = m_iir;
+
+        return true;
+    }
+
+    /**
+     * @brief returns count of accepted samples since reset
+     */
+    uint64_t get_count() { return m_count; }
+
+    /**
+     * @brief returns count of rejected spikes
+     */
+    uint64_t get_spikes() { return m_spikes; }
+
+private:
+    /**
+     * @brief sliding median on sorted window
+     * @param value new value
+     * @returns median of window
+     * @note costs window size, constant per sample
+     */
+    int32_t median(int32_t value)
+    {
+        if (m_med_size == 1)
+            return value;
+
+        uint32_t i;
+
+        if (m_med_count == m_med_size)
+        {
+            // remove oldest value
+            int32_t old = m_med[m_med_pos];
+
+            i = 0;
+
+            while (m_sorted[i] != old)
+                i++;
+
+            memmove(&m_sorted[i], &m_sorted[i + 1], (m_med_count - i - 1) * sizeof(int32_t));
+            m_med_count--;
+        }
+
+        // insert new value in order
+        for (i = m_med_count; (i > 0) && (m_sorted[i - 1] > value); i--)
+            m_sorted[i] = m_sorted[i - 1];
+
+        m_sorted[i] = value;
+        m_med_count++;
+
+        m_med[m_med_pos] = value;
+        m_med_pos = (m_med_pos + 1) % m_med_size;
+
+        return m_sorted[m_med_count / 2];
+    }
+
+    uint32_t m_med_size;  // window of median
+    uint32_t m_mean_size; // window of mean
+    double m_alpha;       // weight of iir
+    uint32_t m_spike;     // max. change of spike rejection
+
+    uint64_t m_count;  // accepted samples
+    int32_t m_last;    // last accepted sample
+    uint32_t m_steps;  // rejected samples in series
+    uint64_t m_spikes; // rejected samples
+
+    int32_t m_med[HX711_FILTER_MAX];    // median window in time order
+    int32_t m_sorted[HX711_FILTER_MAX]; // median window sorted
+    uint32_t m_med_count; // values in median window
+    uint32_t m_med_pos;   // next position in median window
+
+    int32_t m_mean[HX711_FILTER_MAX]; // mean window
+    uint32_t m_mean_count; // values in mean window
+    uint32_t m_mean_pos;   // next position in mean window
+    int64_t m_sum;         // sum of mean window
+
+    double m_iir; // iir output
+};
+
+/**
+ * @brief class c_hx711_base
+ *
+ * dt pins of one or more hx711 and shared cl pin in one line request,
+ * one clock pulse reads bit of all hx711, used by c_hx711 and c_hx711_multi
+ */
+class c_hx711_base
 {
 public:
     /**
      * @brief class constuctor
      */
-    c_hx711()
+    c_hx711_base()
     {
         m_gain = GAIN_A128;
+        m_count = 0;
+        m_dt_mask = 0;
+        m_high_ns = 0;
+        m_ready_ns = 0;
+        m_read_ns = 0;
+        clear_timing();
     }
 
     /**
      * @brief class destructor
      */
-    ~c_hx711()
+    ~c_hx711_base()
     {
         // power down hx711
         power_down();
     }
 
     /**
-     * @brief power down hx711
+     * @brief power down all hx711
      */
     void power_down()
     {
-        m_gpio_cl.write(0);
-        m_gpio_cl.write(1);
+        if (m_lines.get_count() == 0)
+            return;
+
+        m_lines.write(0, LINE_CL);
+        m_lines.write(LINE_CL, LINE_CL);
     }
 
     /**
@@ -64,37 +327,305 @@ public:
      */
     const char* get_error()
     {
-        return m_gpio_dt.get_error();
+        return m_lines.get_error();
     }
 
     /**
-     * @brief inits dt + cl pins and hx711 
+     * @brief returns count of hx711, 0 if not init
+     */
+    uint32_t get_count() { return m_count; }
+
+    /**
+     * @brief returns timing of raw reads
+     * @param timing receives timing
+     */
+    void get_timing(hx711_timing& timing)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        timing = m_timing;
+    }
+
+    /**
+     * @brief clears timing of raw reads
+     */
+    void clear_timing()
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        memset(&m_timing, 0, sizeof(m_timing));
+    }
+
+protected:
+    /**
+     * @brief inits dt pins + shared cl pin and waits all hx711 ready
      * @param chip pointer to chip
-     * @param pin_dt dt pin (0..27)
-     * @param pin_cl cl pin (0..27)
+     * @param pins_dt dt pin (0..27) of each hx711
+     * @param count count of dt pins 1..HX711_MULTI_MAX
+     * @param pin_cl shared cl pin (0..27)
      * @param print_msg flag for print error messages, true = on
      * @returns true: ok, false: error
      */
-    bool init(c_chip* chip, uint32_t pin_dt, uint32_t pin_cl, bool print_msg = false)
+    bool init_lines(c_chip* chip, const uint32_t* pins_dt, uint32_t count, uint32_t pin_cl, bool print_msg)
     {
+        m_lines.setchip(chip, print_msg);
+
         // clear error
         clear_error();
 
-        m_gpio_dt.setchip(chip, print_msg); // dt pin
-        m_gpio_cl.setchip(chip, print_msg); // cl pin
+        if ((count == 0) || (count > HX711_MULTI_MAX))
+            return print_error("hx711: invalid count of dt pins");
 
-        // init cl pin
-        if (!m_gpio_cl.init(pin_cl, GPIO_MODE_OUTPUT))
-            return m_gpio_dt.print_error(m_gpio_cl.get_error());
+        // cl and all dt in one line request, cl is bit 0
+        uint32_t pins[HX711_MULTI_MAX + 1];
+        uint32_t modes[HX711_MULTI_MAX + 1];
 
-        // init dt pin
-        if (!m_gpio_dt.init(pin_dt, GPIO_MODE_INPUT))
+        pins[0] = pin_cl;
+        modes[0] = GPIO_MODE_OUTPUT;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pins[i + 1] = pins_dt[i];
+            modes[i + 1] = GPIO_MODE_INPUT;
+        }
+
+        m_count = 0;
+        m_dt_mask = ((1ull << count) - 1) << 1;
+
+        // falling edge of any dt wakes on ready
+        if (!m_lines.init(pins, modes, count + 1, 0, GPIO_EDGE_FALLING, m_dt_mask))
             return false;
 
-        // wait hx711 ready
+        m_count = count;
+
+        // wait all hx711 ready
         return wait_ready();
     }
 
+    /**
+     * @brief clears message buffer
+     */
+    void clear_error()
+    {
+        m_lines.clear_error();
+    }
+
+    /**
+     * @brief prints error message if enabled on stderr
+     * @param msg message to print
+     * @returns always false
+     */
+    bool print_error(const char* msg)
+    {
+        return m_lines.print_error(msg);
+    }
+
+    /**
+     * @brief waits all hx711 ready until timeout
+     * @returns true: ok, false: timeout or error
+     * @note sleeps until falling edge of any dt, no polling,
+     *       hx711 ready first keeps its data
+     */
+    bool wait_ready()
+    {
+        gpio_event events[GPIO_EVENT_BATCH];
+        uint64_t bits;
+
+        int32_t n;
+
+        // drop edges of data bits of last read, keep time of ready edge
+        m_ready_ns = 0;
+
+        while ((n = m_lines.watch(events, GPIO_EVENT_BATCH, 0)) > 0)
+            edge_time(events, n);
+
+        int64_t end = c_timer::now() + HX711_READY_MS * 1000000l;
+
+        while (1)
+        {
+            // all dt low is ready, also if edge was dropped
+            if (!m_lines.read(bits, m_dt_mask))
+                return false;
+
+            if (bits == 0)
+            {
+                // no edge, ready before init or edge lost
+                if (m_ready_ns == 0)
+                    m_ready_ns = c_timer::now();
+
+                return true;
+            }
+
+            int64_t left = end - c_timer::now();
+
+            if (left <= 0)
+                return print_error("hx711: wait timeout");
+
+            // wait for falling edge of dt
+            if ((n = m_lines.watch(events, GPIO_EVENT_BATCH, (left + 999999) / 1000000)) < 0)
+                return false;
+
+            edge_time(events, n);
+        }
+    }
+
+    /**
+     * @brief sets time of ready from edges after last read
+     * @param events edge events
+     * @param n count of events
+     */
+    void edge_time(const gpio_event* events, int32_t n)
+    {
+        for (int32_t i = 0; i < n; i++)
+            if ((int64_t) events[i].timestamp_ns > m_read_ns)
+                m_ready_ns = events[i].timestamp_ns;
+    }
+
+    /**
+     * @brief waits ready and reads one conversion of all hx711
+     * @param data receives adc data of each hx711
+     * @param gain GAIN_..
+     * @returns true: ok, false: error
+     * @note repeats if clock high was too long, hx711 may be powered down
+     */
+    bool read_conversion(int32_t* data, uint32_t gain)
+    {
+        for (uint32_t i = 0; i < HX711_RETRY; i++)
+        {
+            if (!wait_ready())
+                return false;
+
+            if (!read_raw(data, gain))
+                return false;
+
+            if (m_high_ns <= HX711_HIGH_MAX_NS)
+                return true;
+        }
+
+        return print_error("hx711: clock high too long");
+    }
+
+    /**
+     * @brief read raw data of all hx711
+     * @param values receives adc data of each hx711
+     * @param gain GAIN_..
+     * @returns true: ok, false: gpio error
+     * @note data is valid after rising edge, is sampled after falling edge,
+     *       one clock pulse and its sample of all dt pins take three ioctls without lock and delay
+     */
+    bool read_raw(int32_t* values, uint32_t gain)
+    {
+        // switch priority
+        c_priority priority;
+
+        uint32_t data[HX711_MULTI_MAX] = { 0 };
+        uint64_t bits;
+        bool ok = true;
+
+        m_high_ns = 0;
+
+        int64_t start = c_timer::now();
+        int64_t t0, t1;
+
+        // 24 data pulses and 1..3 gain pulses
+        for (uint32_t i = 0; i < 24 + gain; i++)
+        {
+            t0 = c_timer::now();
+            ok &= m_lines.write(LINE_CL, LINE_CL);
+            ok &= m_lines.write(0, LINE_CL);
+            t1 = c_timer::now();
+
+            // upper bound of clock high time
+            m_high_ns = max(m_high_ns, t1 - t0);
+
+            if (i >= 24)
+                continue;
+
+            ok &= m_lines.read(bits, m_dt_mask);
+
+            // dt of k-th hx711 is bit k + 1
+            for (uint32_t k = 0; k < m_count; k++)
+                data[k] = (data[k] << 1) | (uint32_t) ((bits >> (k + 1)) & 1);
+        }
+
+        // edges before end of read are data bits
+        m_read_ns = c_timer::now();
+
+        m_timing.reads++;
+        m_timing.high_max_ns = max(m_timing.high_max_ns, m_high_ns);
+        m_timing.read_max_ns = max(m_timing.read_max_ns, m_read_ns - start);
+
+        if (m_high_ns > HX711_HIGH_MAX_NS)
+            m_timing.over++;
+
+        // convert to int32_t
+        for (uint32_t k = 0; k < m_count; k++)
+        {
+            if (data[k] & 0x800000)
+                data[k] |= 0xFF000000;
+
+            values[k] = int32_t(data[k]);
+        }
+
+        return ok;
+    }
+
+    // bit mask of cl pin in line request, dt pins follow
+    enum {
+        LINE_CL = 1, // cl pin, bit 0
+    };
+
+    c_lines m_lines;    // cl and dt pins of all hx711
+
+    uint32_t m_gain;    // save gain
+    uint32_t m_count;   // count of hx711
+    uint64_t m_dt_mask; // bit mask of dt pins
+    mutex m_mtx;        // lock mutex
+
+    hx711_timing m_timing; // timing of raw reads
+    int64_t m_high_ns;     // max. clock high of last raw read
+    int64_t m_ready_ns;    // time of ready of actual conversion
+    int64_t m_read_ns;     // end time of last raw read
+};
+
+/**
+ * @brief class c_hx711
+ */
+class c_hx711 : public c_hx711_base
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_hx711() : m_queue(true)
+    {
+        m_stop = true;
+        m_dropped = 0;
+        m_spikes = 0;
+    }
+
+    /**
+     * @brief class destructor
+     * @note base class powers down hx711
+     */
+    ~c_hx711()
+    {
+        stop_stream();
+    }
+
+    /**
+     * @brief inits dt + cl pins and hx711 
+     * @param chip pointer to chip
+     * @param pin_dt dt pin (0..27)
+     * @param pin_cl cl pin (0..27)
+     * @param print_msg flag for print error messages, true = on
+     * @returns true: ok, false: error
+     */
+    bool init(c_chip* chip, uint32_t pin_dt, uint32_t pin_cl, bool print_msg = false)
+    {
+        return init_lines(chip, &pin_dt, 1, pin_cl, print_msg);
+    }
+
     /**
      * @brief read hx711
      * @param value receives hx711 adc value
@@ -113,116 +644,308 @@ public:
         if ((gain < GAIN_A128) || (gain > GAIN_A64))
             return print_error("hx711: invalid gain");
 
+        // stream thread reads hx711
+        if (!m_stop)
+            return print_error("hx711: stream is running");
+
         // adjust nread
         if (nread == 0)
             nread = 5;
 
         value = 0.0;
 
+        int32_t data;
+
         // if gain changed set gain and port with one call
         if (gain != m_gain)
         {
-            if (!wait_ready())
+            if (!read_conversion(&data, gain))
                 return false;
-    
-            read_raw(gain);
+
             m_gain = gain;
         }
     
         // read multiple times
         for (uint32_t i=0; i < nread; i++)
         {
-            if (!wait_ready())
+            if (!read_conversion(&data, gain))
                 return false;
     
-            value += double(read_raw(gain));
+            value += double(data);
         }
     
         // build average
-        value = abs(round(value / double(nread)));
+        value = round(value / double(nread));
     
         return true;
     }
 
-private:
     /**
-     * @brief clears message buffer
+     * @brief starts stream thread, reads each conversion into queue
+     * @param gain GAIN_..
+     * @returns true: ok, false: error or already running
+     * @note read() is not possible while stream is running
+     * @note stream thread uses default priority of calling thread (c_sched)
      */
-    void clear_error()
+    bool start_stream(uint32_t gain = GAIN_A128)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        if ((gain < GAIN_A128) || (gain > GAIN_A64))
+            return print_error("hx711: invalid gain");
+
+        if (!m_stop)
+            return print_error("hx711: stream is running");
+
+        if (m_lines.get_count() == 0)
+            return print_error("hx711: not init");
+
+        m_dropped = 0;
+        m_spikes = 0;
+        m_filter.reset();
+        m_stop = false;
+        m_thread = thread(&c_hx711::stream, this, gain, c_sched::get_default());
+
+        return true;
+    }
+
+    /**
+     * @brief stops stream thread
+     * @note waits until actual conversion is read
+     */
+    void stop_stream()
     {
-        m_gpio_cl.clear_error();
-        m_gpio_dt.clear_error();
+        m_stop = true;
+
+        if (m_thread.joinable())
+            m_thread.join();
     }
 
     /**
-     * @brief prints error message if enabled on stderr
-     * @param msg message to print
-     * @returns always false
+     * @brief pops samples from stream queue (single consumer)
+     * @param samples receives samples in time order
+     * @param n max. count of samples
+     * @returns count of samples
      */
-    bool print_error(const char* msg)
+    uint32_t pop(hx711_sample* samples, uint32_t n)
     {
-        return m_gpio_dt.print_error(msg);
+        return m_queue.pop(samples, n);
     }
 
     /**
-     * @brief waits hx711 ready until timeout
-     * @returns true: ok, false: timeout
+     * @brief waits until stream queue is not empty (single consumer)
+     * @param timeout_ms timeout in ms, -1: wait forever
+     * @returns true: samples available, false: timeout
      */
-    bool wait_ready()
+    bool wait(int32_t timeout_ms = -1)
+    {
+        return m_queue.wait(timeout_ms);
+    }
+
+    /**
+     * @brief returns latest sample of stream without lock (any thread)
+     * @param sample receives sample
+     * @returns false if no sample yet
+     */
+    bool latest(hx711_sample& sample)
     {
-        // wait 600ms for ready
-        for(uint32_t t=0; t < 60; t++)
+        return m_latest.load(sample) != 0;
+    }
+
+    /**
+     * @brief returns count of samples dropped on full queue
+     */
+    uint64_t get_dropped() { return m_dropped; }
+
+    /**
+     * @brief sets filter of stream, see c_hx711_filter::set()
+     * @param median window of sliding median, odd 1..HX711_FILTER_MAX, 1: off
+     * @param mean window of sliding mean 1..HX711_FILTER_MAX, 1: off
+     * @param alpha weight of new value in iir 0.0 < alpha <= 1.0, 1.0: off
+     * @param spike max. change to last accepted sample, 0: off
+     * @returns true: ok, false: error
+     * @note call before start_stream()
+     */
+    bool set_filter(uint32_t median = 1, uint32_t mean = 1, double alpha = 1.0, uint32_t spike = 0)
+    {
+        const lock_guard<mutex> lock(m_mtx);
+
+        // clear error
+        clear_error();
+
+        if (!m_stop)
+            return print_error("hx711: stream is running");
+
+        if (!m_filter.set(median, mean, alpha, spike))
+            return print_error("hx711: invalid filter");
+
+        return true;
+    }
+
+    /**
+     * @brief returns actual filter output of stream without lock (any thread)
+     * @param reading receives filter output
+     * @returns false if no sample yet
+     * @note no wait for conversion
+     */
+    bool filtered(hx711_reading& reading)
+    {
+        return m_filtered.load(reading) != 0;
+    }
+
+    /**
+     * @brief returns count of spikes rejected by filter of stream
+     */
+    uint64_t get_spikes() { return m_spikes; }
+
+private:
+    /**
+     * @brief stream thread
+     * @param gain GAIN_..
+     * @param param default priority of thread that started stream
+     */
+    void stream(uint32_t gain, prio_param param)
+    {
+        // default priority is per thread, take over from creating thread
+        c_sched::set_default(param);
+
+        hx711_sample sample;
+        hx711_reading reading;
+        int32_t data;
+        uint32_t seq = 0;
+
+        while (!m_stop)
         {
-            if (m_gpio_dt.read() == 0)
-                return true;
-            
-            m_timer.sleep_ms(10); // delay 10ms
+            bool ok;
+
+            {
+                const lock_guard<mutex> lock(m_mtx);
+
+                // first conversion after gain change has old gain
+                if (gain != m_gain)
+                {
+                    if (read_conversion(&data, gain))
+                        m_gain = gain;
+
+                    continue;
+                }
+
+                ok = read_conversion(&data, gain);
+            }
+
+            if (!ok)
+                continue;
+
+            sample.time_ns = m_ready_ns;
+            sample.value = data;
+            sample.seq = ++seq;
+
+            m_latest.store(sample);
+
+            if (!m_queue.push(sample))
+                m_dropped++;
+
+            // filter each sample, also dropped
+            if (m_filter.add(data))
+            {
+                m_filter.get(reading.value);
+                reading.time_ns = sample.time_ns;
+                reading.seq = sample.seq;
+
+                m_filtered.store(reading);
+            }
+
+            m_spikes = m_filter.get_spikes();
         }
+    }
 
-        return print_error("hx711: wait timeout");
+    c_spsc_queue<hx711_sample, HX711_STREAM_SIZE> m_queue; // stream queue
+    c_seqlock<hx711_sample> m_latest; // latest sample of stream
+    c_hx711_filter m_filter;          // filter of stream thread
+    c_seqlock<hx711_reading> m_filtered; // filter output of stream
+    atomic_uint64_t m_spikes; // spikes rejected by filter
+    thread m_thread;          // stream thread
+    atomic_bool m_stop;       // stop flag of stream thread
+    atomic_uint64_t m_dropped; // samples dropped on full queue
+};
+
+/**
+ * @brief class c_hx711_multi
+ * @note hx711 with own dt pin and shared cl pin, one clock pulse reads bit of all hx711,
+ *       all hx711 are read out together on one shared clock in time of one,
+ *       each hx711 converts on own oscillator, readout is aligned, not conversion time
+ */
+class c_hx711_multi : public c_hx711_base
+{
+public:
+    /**
+     * @brief inits dt pins + shared cl pin and all hx711
+     * @param chip pointer to chip
+     * @param pins_dt dt pin (0..27) of each hx711, 1..HX711_MULTI_MAX pins
+     * @param pin_cl shared cl pin (0..27)
+     * @param print_msg flag for print error messages, true = on
+     * @returns true: ok, false: error
+     */
+    bool init(c_chip* chip, const vector<uint32_t>& pins_dt, uint32_t pin_cl, bool print_msg = false)
+    {
+        return init_lines(chip, pins_dt.data(), pins_dt.size(), pin_cl, print_msg);
     }
 
     /**
-     * @brief read hx711 raw data
+     * @brief reads all hx711
+     * @param values receives adc value of each hx711
      * @param gain GAIN_..
-     * @returns hx711 adc data
+     * @param nread count of reads for average (1..)
+     * @returns true: ok, false: error
      */
-    int32_t read_raw(uint32_t gain)
+    bool read(vector<double>& values, uint32_t gain = GAIN_A128, uint32_t nread = 5)
     {
-        // switch priority
-        c_priority priority;
+        const lock_guard<mutex> lock(m_mtx);
 
-        uint32_t data = 0;
-    
-        // read from hx711
-        for (int32_t i = 0; i < 24; i++)
+        // clear error
+        clear_error();
+
+        // check gain
+        if ((gain < GAIN_A128) || (gain > GAIN_A64))
+            return print_error("hx711: invalid gain");
+
+        if (m_count == 0)
+            return print_error("hx711: not init");
+
+        // adjust nread
+        if (nread == 0)
+            nread = 5;
+
+        values.assign(m_count, 0.0);
+
+        int32_t data[HX711_MULTI_MAX];
+
+        // if gain changed set gain of all hx711
+        if (gain != m_gain)
         {
-            m_gpio_cl.write(1);
-            m_timer.delay_ns(100l); // delay 100ns
-            data = (data << 1) | m_gpio_dt.read();
-            m_gpio_cl.write(0);
-            m_timer.delay_us(1l); // delay 1us
+            if (!read_conversion(data, gain))
+                return false;
+
+            m_gain = gain;
         }
-    
-        // set gain
-        for (uint8_t i = 0; i < gain; i++)
+
+        // read multiple times
+        for (uint32_t i = 0; i < nread; i++)
         {
-            m_gpio_cl.write(1);
-            m_timer.delay_us(1l); // delay 1us
-            m_gpio_cl.write(0);
-        }
-    
-        // convert to int32_t
-        if (data & 0x800000)
-            data |= 0xFF000000;
+            if (!read_conversion(data, gain))
+                return false;
 
-        return int32_t(data);
-    }
+            for (uint32_t k = 0; k < m_count; k++)
+                values[k] += double(data[k]);
+        }
 
-    c_gpio m_gpio_dt; // hx711 data gpio
-    c_gpio m_gpio_cl; // hx711 clock gpio
+        // build average
+        for (uint32_t k = 0; k < m_count; k++)
+            values[k] = round(values[k] / double(nread));
 
-    uint32_t m_gain;  // save gain
-    mutex m_mtx;      // lock mutex
-    c_timer m_timer;  // timer
+        return true;
+    }
 };
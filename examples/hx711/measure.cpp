@@ -25,6 +25,7 @@ using namespace std;
 
 #define PRINT_MSG true // print error on console
 #define WUNITS "g"     // units of reference weight
+#define RT_PRIO 40     // FIFO priority below kernel irq threads (50)
 
 // only one chip
 c_chip chip;
@@ -32,11 +33,14 @@ c_chip chip;
 // hx711 driver
 c_hx711 hx711;
 
+// set by signal handler, checked in read loop
+volatile sig_atomic_t stop = 0;
+
 // signal handler
 void onCtrlC(int signum)
 {
-    puts("\n program stopped");
-    exit(signum);
+    // no lock and no print in signal context
+    stop = signum;
 }
 
 int main()
@@ -62,15 +66,22 @@ int main()
         return 1;
     }
 
-    // create timer
-    c_timer timer;
+    // create 1s period
+    c_periodic period(1000000000l);
+
+    // read hx711 with FIFO priority below irq threads, gpio events are not blocked
+    prio_param prio = { PRIO_FIFO, RT_PRIO, 0, 0, 0 };
+    c_sched::set_default(prio);
 
     // init hx711
     if (!hx711.init(&chip, DT_PIN, CL_PIN, PRINT_MSG))
         return 1;
 
+    // start period
+    period.start();
+
     // read loop
-    while(1)
+    while(!stop)
     {
         double adc_val;
 
@@ -84,10 +95,20 @@ int main()
 
         printf("weight: %.2f %s\n", WUNITS, weight);
         
-        // sleep 1s
-        timer.sleep_s(1);
+        // sleep until next period
+        period.wait();
     }
 
+    hx711_timing timing;
+    hx711.get_timing(timing);
+
+    // clock high must be below 60us, else hx711 powers down
+    printf("\n raw reads: %llu, max. clock high: %lldns, max. read: %lldns, too long: %llu\n",
+        (unsigned long long) timing.reads, (long long) timing.high_max_ns,
+        (long long) timing.read_max_ns, (unsigned long long) timing.over);
+
+    puts(" program stopped");
+
     return 0;
 }
 
@@ -0,0 +1,70 @@
+/*
+ * example reads many hx711 load cells with shared clock at same time
+ *
+ * connect hx711 DOUT pins to gpio pin 21, 22, 23 and 24
+ * connect PD_SCK of all hx711 to gpio pin 20
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./multi
+ *
+ */
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_hx711.h"
+
+#define CL_PIN 20 // gpio pin for PD_SCK pin of all hx711
+
+#define PRINT_MSG true // print error on console
+#define NREAD 1        // reads for average, 1: each conversion
+
+// gpio pins for hx711 DOUT pins
+const vector<uint32_t> dt_pins = { 21, 22, 23, 24 };
+
+// only one chip
+c_chip chip;
+
+// hx711 driver of all load cells
+c_hx711_multi hx711;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** hx711 multi C++ example ***");
+
+    if (!hx711.init(&chip, dt_pins, CL_PIN, PRINT_MSG))
+        return 1;
+
+    vector<double> values;
+
+    // read loop, all load cells in time of one
+    while(1)
+    {
+        if (!hx711.read(values, GAIN_A128, NREAD))
+            return 1;
+
+        double sum = 0.0;
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            printf("%.0f ", values[i]);
+            sum += values[i];
+        }
+
+        printf("sum: %.0f\n", sum);
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * example streams each hx711 conversion with time of ready
+ * first run calib program to get calibration values
+ *
+ * connect hx711 DOUT to gpio pin 21 and PD_SCK to gpio pin 20
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./stream
+ *
+ */
+#include<iostream>
+using namespace std;
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "c_hx711.h"
+
+#define DT_PIN 21 // gpio pin for hx711 DOUT pin
+#define CL_PIN 20 // gpio pin for hx711 PD_SCK pin
+
+#define PRINT_MSG true // print error on console
+#define WUNITS "g"     // units of reference weight
+#define BATCH 16       // max. samples of one pop
+
+#define FILTER_MEDIAN 5  // window of sliding median, removes single spikes
+#define FILTER_MEAN 8    // window of sliding mean
+#define FILTER_ALPHA 1.0 // iir off
+#define FILTER_SPIKE 0   // spike rejection off
+
+// only one chip
+c_chip chip;
+
+// hx711 driver
+c_hx711 hx711;
+
+// set by signal handler, checked in read loop
+volatile sig_atomic_t stop = 0;
+
+// signal handler
+void onCtrlC(int signum)
+{
+    // no join and no print in signal context
+    stop = signum;
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** hx711 stream C++ example ***");
+
+    double tare_val = 0.0;
+    double factor_val = 0.0;
+
+    cout << "enter tare value: ";
+    cin >> tare_val;
+
+    cout << "enter factor value: ";
+    cin >> factor_val;
+
+    if (factor_val == 0.0)
+    {
+        puts("invalid factor value");
+        return 1;
+    }
+
+    if (!hx711.init(&chip, DT_PIN, CL_PIN, PRINT_MSG))
+        return 1;
+
+    // filter each conversion in stream thread
+    if (!hx711.set_filter(FILTER_MEDIAN, FILTER_MEAN, FILTER_ALPHA, FILTER_SPIKE))
+        return 1;
+
+    // read each conversion in background
+    if (!hx711.start_stream(GAIN_A128))
+        return 1;
+
+    hx711_sample samples[BATCH];
+    int64_t last_ns = 0;
+
+    // print each sample with time since last sample
+    while(!stop)
+    {
+        if (!hx711.wait(1000))
+        {
+            // wait is interrupted by signal
+            if (!stop)
+                puts("no sample");
+
+            continue;
+        }
+
+        uint32_t n = hx711.pop(samples, BATCH);
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            double weight = (samples[i].value - tare_val) / factor_val;
+
+            printf("#%u weight: %.2f%s dt: %.1fms\n", samples[i].seq, weight, WUNITS,
+                (last_ns == 0) ? 0.0 : (samples[i].time_ns - last_ns) / 1000000.0);
+
+            last_ns = samples[i].time_ns;
+        }
+
+        hx711_reading reading;
+
+        // actual filter output, no wait for conversion
+        if (hx711.filtered(reading))
+            printf("filtered weight: %.2f%s\n", (reading.value - tare_val) / factor_val, WUNITS);
+    }
+
+    hx711.stop_stream();
+
+    printf("\n dropped samples: %llu\n", (unsigned long long) hx711.get_dropped());
+
+    puts(" program stopped");
+
+    return 0;
+}
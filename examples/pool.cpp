@@ -0,0 +1,107 @@
+/*
+ * example runs short workers in thread pool
+ *
+ * connect leds to gpio pins 20 and 21 with resistors (220-470 Ohm) and common to ground 
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./pool
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "../include/gpiox.h"
+#include "../include/c_worker.h"
+#include "../include/c_timer.h"
+
+#define OUTPUT_PIN1 21
+#define OUTPUT_PIN2 20
+
+#define BLINK_TIME_MS 500 // ms
+#define POOL_THREADS 2 // count of pool threads
+
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// gpio
+c_gpio gpio1(&chip, PRINT_MSG);
+c_gpio gpio2(&chip, PRINT_MSG);
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+
+    // clear outputs
+    gpio1.write(0);
+    gpio2.write(0);
+
+    exit(signum);
+}
+
+// derived toggle worker class
+class c_toggle : public c_worker
+{
+public:
+    c_toggle(c_gpio* gpio)
+    {
+        m_gpio = gpio;
+    }
+
+    ~c_toggle() {}
+
+    // execute in pool thread 
+    void Execute() override
+    {
+        // toggle output
+        m_gpio->toggle();
+    }
+
+private:
+    c_gpio* m_gpio;
+};
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** thread pool C++ example ***");
+    puts("stop program with Ctrl+C");
+
+    // init output 1
+    if (!gpio1.init(OUTPUT_PIN1, GPIO_MODE_OUTPUT))
+        return 1;
+
+    // init output 2
+    if (!gpio2.init(OUTPUT_PIN2, GPIO_MODE_OUTPUT))
+        return 1;
+
+    // create pool, threads are created once
+    c_pool pool(POOL_THREADS);
+
+    // create timer
+    c_timer timer;
+
+    while(1)
+    {
+        // queue workers, workers are deleted by pool
+        future<void> f1 = (new c_toggle(&gpio1))->Queue(pool);
+        future<void> f2 = (new c_toggle(&gpio2))->Queue(pool);
+
+        // wait until both workers ends
+        f1.wait();
+        f2.wait();
+
+        // sleep
+        timer.sleep_ms(BLINK_TIME_MS);
+    }
+
+    return 0;
+}
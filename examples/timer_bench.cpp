@@ -0,0 +1,238 @@
+/*
+ * benchmark measures accuracy and jitter of c_timer delay and sleep
+ *
+ * sweeps requested time from 100ns to 100ms and prints overshoot
+ * percentiles and histogram for each time and mode
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./timer_bench [-f] [-c] [-l nload] [-n nloop] [-m spin|sleep]
+ *   -f       run with SCHED_FIFO (c_priority)
+ *   -c       spin short delays on cpu cycle counter
+ *   -l nload start nload background load threads
+ *   -n nloop count of measures per time (default 1000)
+ *   -m mode  measure only spin (delay) or sleep
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+using namespace std;
+
+#include "../include/c_timer.h"
+#include "../include/c_priority.h"
+
+// count of histogram buckets, bucket n: overshoot < 2^n us
+#define N_BUCKET 12
+
+// max. measure time per requested time
+#define MAX_POINT_NS 1000000000l
+
+// requested times in ns
+const int64_t req_times[] = {
+    100l, 200l, 500l,
+    1000l, 2000l, 5000l,
+    10000l, 20000l, 50000l,
+    100000l, 200000l, 500000l,
+    1000000l, 2000000l, 5000000l,
+    10000000l, 20000000l, 50000000l,
+    100000000l
+};
+
+// stop flag for load threads
+atomic_bool stop_load(false);
+
+// background load
+void load_thread()
+{
+    volatile uint64_t x = 0;
+
+    while(!stop_load)
+        x = x + 1;
+}
+
+// prints time in readable units
+void print_time(int64_t ns)
+{
+    if (ns < 1000l)
+        printf("%7lldns", (long long) ns);
+    else if (ns < 1000000l)
+        printf("%7.1fus", ns / 1000.0);
+    else
+        printf("%7.2fms", ns / 1000000.0);
+}
+
+// measures one requested time
+void measure(c_timer& timer, bool spin, int64_t req, uint32_t nloop)
+{
+    // limit measure time
+    if (int64_t(nloop) * req > MAX_POINT_NS)
+        nloop = MAX_POINT_NS / req;
+
+    if (nloop < 10)
+        nloop = 10;
+
+    vector<int64_t> over(nloop);
+    uint32_t hist[N_BUCKET + 1];
+
+    memset(hist, 0, sizeof(hist));
+
+    for (uint32_t i = 0; i < nloop; i++)
+    {
+        int64_t t = c_timer::now();
+
+        if (spin)
+            timer.delay_ns(req);
+        else
+            timer.sleep_ns(req);
+
+        over[i] = c_timer::now() - t - req;
+
+        // histogram bucket in us (log2)
+        int64_t us = over[i] / 1000;
+        uint32_t b = 0;
+
+        while ((b < N_BUCKET) && (us >= (1l << b)))
+            b++;
+
+        hist[b]++;
+    }
+
+    sort(over.begin(), over.end());
+
+    printf("%-5s ", spin ? "spin" : "sleep");
+    print_time(req);
+    print_time(over[0]);
+    print_time(over[nloop / 2]);
+    print_time(over[(nloop * 99) / 100]);
+    print_time(over[(nloop * 999) / 1000]);
+    print_time(over[nloop - 1]);
+
+    // print histogram
+    printf("  ");
+
+    for (uint32_t b = 0; b <= N_BUCKET; b++)
+        printf(" %7u", hist[b]);
+
+    printf("\n");
+}
+
+// prints command line options
+void print_usage()
+{
+    puts("usage: timer_bench [-f] [-c] [-l nload] [-n nloop] [-m spin|sleep]");
+}
+
+int main(int argc, char* argv[])
+{
+    bool fifo = false;
+    bool cycles = false;
+    uint32_t nload = 0;
+    uint32_t nloop = 1000;
+    bool do_spin = true;
+    bool do_sleep = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fcl:n:m:")) != -1)
+    {
+        switch(opt)
+        {
+        case 'f':
+            fifo = true;
+            break;
+        case 'c':
+            cycles = true;
+            break;
+        case 'l':
+            nload = atoi(optarg);
+            break;
+        case 'n':
+            nloop = atoi(optarg);
+            break;
+        case 'm':
+            do_spin = (strcmp(optarg, "spin") == 0);
+            do_sleep = (strcmp(optarg, "sleep") == 0);
+
+            // unknown mode measures nothing
+            if (!do_spin && !do_sleep)
+            {
+                print_usage();
+                return 1;
+            }
+            break;
+        default:
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (nloop == 0)
+        nloop = 1000;
+
+    puts("*** timer benchmark C++ example ***");
+
+    // start background load
+    vector<thread> load;
+
+    for (uint32_t i = 0; i < nload; i++)
+        load.emplace_back(load_thread);
+
+    // switch priority
+    c_priority priority(true);
+
+    if (fifo)
+        priority.set();
+
+    // create timer, calibrate spin slice with actual priority
+    c_timer timer;
+    c_timer::calibrate();
+
+    // switch to cycle counter
+    if (cycles && !c_timer::use_cycles(true))
+        puts("cycle counter not available, use clock_gettime");
+
+    printf("policy: %s, load threads: %u, counter: %s, spin slice: ",
+        fifo ? "SCHED_FIFO" : "SCHED_OTHER", nload, cycles ? "cycles" : "clock");
+    print_time(c_timer::spin_ns());
+    printf("\n\n");
+
+    printf("mode    request      min   median      p99     p999      max  ");
+
+    for (uint32_t b = 0; b < N_BUCKET; b++)
+    {
+        char label[16];
+        snprintf(label, sizeof(label), "<%ldus", 1l << b);
+        printf(" %7s", label);
+    }
+
+    printf(" %7s\n", "more");
+
+    for (int64_t req: req_times)
+        if (do_spin)
+            measure(timer, true, req, nloop);
+
+    for (int64_t req: req_times)
+        if (do_sleep)
+            measure(timer, false, req, nloop);
+
+    // restore priority
+    if (fifo)
+        priority.restore();
+
+    // stop background load
+    stop_load = true;
+
+    for (thread& th: load)
+        th.join();
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * example watch input with userspace filter
+ *
+ * connect switch to gpio pin 21 and to ground 
+ * 
+ * build:
+ * > make
+ *
+ * run:
+ * > ./watch_filter
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "../include/gpiox.h"
+
+#define INPUT_PIN  21
+
+#define MIN_PULSE_US 200 // us
+#define DEBOUNCE_US 10000 // us
+#define HOLDOFF_US 0 // us
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// gpio
+c_gpio gpio1(&chip, PRINT_MSG);
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+    exit(signum);
+}
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** watch filter C++ example ***");
+    puts("stop program with Ctrl+C");
+
+    // set userspace filter, kernel debounce is off
+    gpio_filter filter = { MIN_PULSE_US, DEBOUNCE_US, HOLDOFF_US };
+    gpio1.set_filter(filter);
+
+    // init input with edge
+    if (!gpio1.init(INPUT_PIN, GPIO_MODE_INPUT_PULLUP, 0, GPIO_EDGE_BOTH))
+        return 1;
+
+    gpio_event events[GPIO_EVENT_BATCH];
+
+    // watch input
+    while(1)
+    {
+        int32_t n = gpio1.watch(events, GPIO_EVENT_BATCH);
+
+        if (n == -1)
+            return 1;
+
+        // print events
+        for (int32_t i = 0; i < n; i++)
+            printf("%s edge occurs on pin %d at %llu us\n",
+                (events[i].edge == GPIO_EDGE_RISING) ? "rising" : "falling",
+                events[i].pin,
+                (unsigned long long) (events[i].timestamp_ns / 1000));
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * example watch input in thread and pass events with queue
+ *
+ * connect switch to gpio pin 21 and to ground 
+ *
+ * build:
+ * > make
+ *
+ * run:
+ * > ./watch_queue
+ *
+ */
+
+#include <stdio.h>
+#include <csignal>
+#include <cstdlib>
+
+#include "../include/gpiox.h"
+#include "../include/c_worker.h"
+#include "../include/c_queue.h"
+
+#define INPUT_PIN 21
+#define DEBOUNCE_US 10000 // us
+
+#define PRINT_MSG true // print error on console
+
+// only one chip
+c_chip chip;
+
+// gpio
+c_gpio gpio1(&chip, PRINT_MSG);
+
+// event queue with eventfd wakeup
+c_spsc_queue<gpio_event, 256> queue(true);
+
+// signal handler
+void onCtrlC(int signum)
+{
+    puts("\n program stopped");
+
+    exit(signum);
+}
+
+// derived watch worker class
+class c_watch : public c_worker
+{
+public:
+    c_watch(c_gpio* gpio)
+    {
+        m_gpio = gpio;
+    }
+
+    ~c_watch() {}
+
+    // execute thread 
+    void Execute() override
+    {
+        gpio_event events[GPIO_EVENT_BATCH];
+        int32_t n;
+
+        // watch input and pass events to queue, never blocks on consumer
+        while((n = m_gpio->watch(events, GPIO_EVENT_BATCH)) > 0)
+        {
+            if (queue.push(events, n) != uint32_t(n))
+                puts("queue full, events lost");
+        }
+    }
+
+private:
+    c_gpio* m_gpio;
+};
+
+int main()
+{
+    signal(SIGINT, onCtrlC);
+
+    puts("*** watch queue C++ example ***");
+    puts("stop program with Ctrl+C");
+
+    // init input with edge
+    if (!gpio1.init(INPUT_PIN, GPIO_MODE_INPUT_PULLUP, DEBOUNCE_US, GPIO_EDGE_BOTH))
+        return 1;
+
+    // create and start watch thread
+    c_watch* wk = new c_watch(&gpio1);
+    wk->Queue(false);
+
+    gpio_event events[32];
+
+    // consume events
+    while(1)
+    {
+        // wait for events
+        queue.wait();
+
+        uint32_t n = queue.pop(events, 32);
+
+        for (uint32_t i = 0; i < n; i++)
+            printf("%s edge occurs on pin %d\n",
+                (events[i].edge == GPIO_EDGE_RISING) ? "rising" : "falling",
+                events[i].pin);
+    }
+
+    return 0;
+}
@@ -0,0 +1,854 @@
+/*
+ * 1-wire bus master
+ *
+ * (c) Derya Y. iiot2k@gmail.com
+ *
+ * c_onewire.h
+ *
+ */
+
+#pragma once
+
+#include <optional>
+using namespace std;
+
+#include "gpiox.h"
+#include "c_timer.h"
+#include "c_priority.h"
+
+// 1-wire standard speed slot timing in ns
+#define OW_RESET_LOW      480000l // reset pulse
+#define OW_RESET_SAMPLE    70000l // presence sample after release
+#define OW_RESET_SLOT     960000l // reset + presence slot
+#define OW_WRITE1_LOW       6000l // write 1 low time
+#define OW_WRITE0_LOW      60000l // write 0 low time
+#define OW_READ_LOW         6000l // read low time
+#define OW_READ_SAMPLE      9000l // read sample after slot start
+#define OW_SLOT            70000l // slot time incl. recovery
+
+// 1-wire rom commands
+enum {
+    OW_SEARCH_ROM = 0xF0,
+    OW_READ_ROM   = 0x33,
+    OW_MATCH_ROM  = 0x55,
+    OW_SKIP_ROM   = 0xCC,
+    OW_ALARM_SEARCH = 0xEC,
+};
+
+// 64bit rom id
+typedef unsigned long long ow_id;
+
+/**
+ * @brief crc table of polynom x^8 + x^5 + x^4 + 1, built on compile
+ */
+struct ow_crc_table {
+    uint8_t table[256];
+
+    constexpr ow_crc_table() : table()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint8_t crc = i;
+
+            for (uint8_t b = 0; b < 8; b++)
+                crc = (crc & 0x01) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+
+            table[i] = crc;
+        }
+    }
+};
+
+/**
+ * @brief rom search on buses, one step
+ * @param BUS c_onewire or c_onewire_multi, bit n of mask is n-th bus,
+ *        uses reset(mask), write_byte(byte, mask), read_bit(mask) and write_bit(bits, mask)
+ * @param bus 1-wire bus
+ * @param count count of buses
+ * @param cmd OW_SEARCH_ROM or OW_ALARM_SEARCH
+ * @param ids ids[n] is 64 bit rom id of n-th bus, last found id on input
+ * @param lastbits lastbits[n] is last discrepancy bit of n-th bus, 64 on start
+ * @param result result[n] of n-th bus, -2: repeat, -1: error, 0: no more devices, 1: device found
+ * @param mask selected buses
+ * @returns mask of buses with device found
+ */
+template <typename BUS>
+uint64_t ow_search(BUS& bus, uint32_t count, uint8_t cmd, ow_id* ids, int8_t* lastbits, int8_t* result, uint64_t mask)
+{
+    for (uint32_t n = 0; n < count; n++)
+    {
+        if (!(mask & (1ULL << n)))
+            continue;
+
+        int8_t& lastbit = lastbits[n];
+
+        // no more id's on bus
+        if (lastbit < 0)
+        {
+            result[n] = 0;
+            mask &= ~(1ULL << n);
+            continue;
+        }
+
+        // set bit in id and reset remaining id bits
+        if (lastbit < 64)
+        {
+            ids[n] |= 1ULL << lastbit;
+
+            if (lastbit < 63)
+                ids[n] &= ~(~0ULL << (lastbit + 1));
+        }
+
+        lastbit = -1;
+        result[n] = -1;
+    }
+
+    // resets buses, buses without device report error
+    mask = bus.reset(mask);
+
+    if (mask == 0)
+        return 0;
+
+    bus.write_byte(cmd, mask);
+
+    // examine 64bit stream on all buses
+    for (int8_t idx = 0; (idx < 64) && (mask != 0); idx++)
+    {
+        // read bits in sequence
+        uint64_t bit = bus.read_bit(mask);
+        uint64_t nobit = bus.read_bit(mask);
+
+        // no device answers, repeat on these buses
+        uint64_t mismatch = bit & nobit;
+
+        for (uint32_t n = 0; n < count; n++)
+            if (mismatch & (1ULL << n))
+                result[n] = -2;
+
+        mask &= ~mismatch;
+
+        // both values on bus
+        uint64_t both = ~bit & ~nobit & mask;
+        uint64_t dir = bit & mask;
+
+        for (uint32_t n = 0; n < count; n++)
+        {
+            uint64_t m = 1ULL << n;
+
+            if (both & m)
+            {
+                if ((ids[n] >> idx) & 1)
+                    dir |= m;
+                else
+                    lastbits[n] = idx;
+            }
+            else if (mask & m) // all devices have same bit
+            {
+                if (bit & m)
+                    ids[n] |= 1ULL << idx;
+                else
+                    ids[n] &= ~(1ULL << idx);
+            }
+        }
+
+        bus.write_bit(dir, mask);
+    }
+
+    // valid id found
+    for (uint32_t n = 0; n < count; n++)
+        if (mask & (1ULL << n))
+            result[n] = 1;
+
+    return mask;
+}
+
+/**
+ * @brief class c_onewire
+ *
+ * 1-wire bus master on one gpio pin,
+ * line is open drain output, released bus is read without reconfig,
+ * slots use absolute deadlines, ioctl time is part of slot time
+ * @note not thread-safe, lock in device driver
+ */
+class c_onewire
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_onewire()
+    {
+        m_bits = 0;
+        m_bus_ns = 0;
+        m_begin_ns = 0;
+    }
+
+    /**
+     * @brief inits bus gpio pin as open drain output, released
+     * @param chip pointer to chip
+     * @param pin bus pin (0..27)
+     * @param print_msg flag for print error messages, true = on
+     * @returns true: ok, false: error
+     */
+    bool init(c_chip* chip, uint32_t pin, bool print_msg = false)
+    {
+        m_gpio.setchip(chip, print_msg);
+
+        // open drain, active low: 1 pulls bus low, 0 releases bus
+        return m_gpio.init(pin, GPIO_MODE_OUTPUT_SINK, 0);
+    }
+
+    /**
+     * @brief returns bus gpio
+     */
+    c_gpio& gpio() { return m_gpio; }
+
+    /**
+     * @brief returns error message
+     */
+    const char* get_error() { return m_gpio.get_error(); }
+
+    /**
+     * @brief clears error message
+     */
+    void clear_error() { m_gpio.clear_error(); }
+
+    /**
+     * @brief prints error message if enabled on stderr
+     * @param msg message to print
+     * @returns always false
+     */
+    bool print_error(const char* msg) { return m_gpio.print_error(msg); }
+
+    /**
+     * @brief begins transaction, switch priority once for all slots
+     * @note uses default priority of actual thread
+     */
+    void begin()
+    {
+        if (m_priority)
+            return;
+
+        m_priority.emplace();
+        m_begin_ns = c_timer::now();
+    }
+
+    /**
+     * @brief ends transaction, restore priority
+     */
+    void end()
+    {
+        if (!m_priority)
+            return;
+
+        m_bus_ns += c_timer::now() - m_begin_ns;
+        m_priority.reset();
+    }
+
+    /**
+     * @brief resets bus
+     * @returns true: presence pulse, false: no device on bus or error
+     * @note no message if no device on bus
+     */
+    bool reset()
+    {
+        if (m_gpio.get_pin() == -1)
+            return print_error("onewire: not init");
+
+        int64_t t = c_timer::now();
+
+        if (!set_low())
+            return print_error(NULL);
+
+        m_timer.delay_until(t + OW_RESET_LOW);
+        set_release();
+        m_timer.delay_until(t + OW_RESET_LOW + OW_RESET_SAMPLE);
+        int32_t bit = get();
+        m_timer.delay_until(t + OW_RESET_SLOT);
+
+        // devices pull bus low on presence
+        return bit == 0;
+    }
+
+    /**
+     * @brief writes one bit slot
+     * @param bit bit to write
+     */
+    void write_bit(uint8_t bit)
+    {
+        int64_t t = c_timer::now();
+
+        set_low();
+        m_timer.delay_until(t + (bit ? OW_WRITE1_LOW : OW_WRITE0_LOW));
+        set_release();
+        m_timer.delay_until(t + OW_SLOT);
+
+        m_bits++;
+    }
+
+    /**
+     * @brief reads one bit slot
+     * @returns bit value
+     */
+    uint8_t read_bit()
+    {
+        int64_t t = c_timer::now();
+
+        set_low();
+        m_timer.delay_until(t + OW_READ_LOW);
+        set_release();
+        m_timer.delay_until(t + OW_READ_SAMPLE);
+        uint8_t bit = get();
+        m_timer.delay_until(t + OW_SLOT);
+
+        m_bits++;
+
+        return bit;
+    }
+
+    /**
+     * @brief writes one byte, lsb first
+     * @param byte data to write
+     */
+    void write_byte(uint8_t byte)
+    {
+        for (uint8_t i = 0; i < 8; i++)
+            write_bit((byte >> i) & 1);
+    }
+
+    /**
+     * @brief reads one byte, lsb first
+     * @returns byte value
+     */
+    uint8_t read_byte()
+    {
+        uint8_t byte = 0;
+
+        for (uint8_t i = 0; i < 8; i++)
+            if (read_bit())
+                byte |= (1 << i);
+
+        return byte;
+    }
+
+    /**
+     * @brief writes multiple bytes
+     * @param data points to data to send
+     * @param len length of data
+     */
+    void write_block(const uint8_t* data, uint8_t len)
+    {
+        for (uint8_t i = 0; i < len; i++)
+            write_byte(data[i]);
+    }
+
+    /**
+     * @brief reads multiple bytes
+     * @param data points to data to receive
+     * @param len length of data
+     */
+    void read_block(uint8_t* data, uint8_t len)
+    {
+        for (uint8_t i = 0; i < len; i++)
+            data[i] = read_byte();
+    }
+
+    /**
+     * @brief resets bus and selects device
+     * @param id 64 bit rom id, NULL: skip rom (all devices)
+     * @returns true: ok, false: no device or error
+     */
+    bool select(const ow_id* id)
+    {
+        if (!reset())
+            return false;
+
+        if (id == NULL)
+            write_byte(OW_SKIP_ROM);
+        else
+        {
+            write_byte(OW_MATCH_ROM);
+            write_block((const uint8_t*) id, 8);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief rom search, one step
+     * @param cmd OW_SEARCH_ROM or OW_ALARM_SEARCH
+     * @param id 64 bit rom id, last found id on input
+     * @param lastbit last discrepancy bit position, 64 on start
+     * @returns -2: repeat, -1: error, 0: no more devices, 1: device found
+     */
+    int8_t search(uint8_t cmd, ow_id& id, int8_t& lastbit)
+    {
+        int8_t result = 0;
+
+        ow_search(*this, 1, cmd, &id, &lastbit, &result, 1);
+
+        return result;
+    }
+
+    /**
+     * @brief crc calculation (Dallas/Maxim), table driven
+     * @param data points to data for calculation
+     * @param len length of data for calculation
+     * @returns crc value
+     */
+    static uint8_t crc8(const uint8_t* data, uint8_t len)
+    {
+        uint8_t crc = 0;
+
+        while (len--)
+            crc = m_crc_table.table[crc ^ *data++];
+
+        return crc;
+    }
+
+    /**
+     * @brief returns count of bit slots since start
+     */
+    uint64_t get_bits() { return m_bits; }
+
+    /**
+     * @brief returns bus throughput of transactions
+     * @returns bits/s, 0 if no transaction
+     */
+    double get_bits_per_sec()
+    {
+        if (m_bus_ns == 0)
+            return 0.0;
+
+        return double(m_bits) * double(NSEC_PER_SEC) / double(m_bus_ns);
+    }
+
+    /**
+     * @brief clears throughput counter
+     */
+    void clear_stats()
+    {
+        m_bits = 0;
+        m_bus_ns = 0;
+    }
+
+    /**
+     * @brief get bit of 64bit id
+     */
+    static inline uint8_t getbit(const ow_id& id, int8_t bit)
+    {
+        return (id >> bit) & 1;
+    }
+
+    /**
+     * @brief set bit on 64bit id
+     */
+    static inline void setbit(ow_id& id, int8_t bit, uint8_t bitval)
+    {
+        if ((bit < 0) || (bit >= 64))
+            return;
+
+        if (bitval == 0)
+            id &= ~(1ULL << bit);
+        else
+            id |= (1ULL << bit);
+    }
+
+private:
+    template <typename BUS>
+    friend uint64_t ow_search(BUS&, uint32_t, uint8_t, ow_id*, int8_t*, int8_t*, uint64_t);
+
+    // bus interface of ow_search, bit 0 of mask is bus
+    uint64_t reset(uint64_t mask) { return ((mask & 1) && reset()) ? 1 : 0; }
+    void write_byte(uint8_t byte, uint64_t mask) { if (mask & 1) write_byte(byte); }
+    uint64_t read_bit(uint64_t mask) { return (mask & 1) ? read_bit() : 0; }
+    void write_bit(uint64_t bits, uint64_t mask) { if (mask & 1) write_bit(uint8_t(bits & 1)); }
+
+    /**
+     * @brief pulls bus low, direct ioctl without lock
+     */
+    inline bool set_low()
+    {
+        gpio_v2_line_values values = { 1, 1 };
+        return ioctl(m_gpio.get_fd(), GPIO_V2_LINE_SET_VALUES_IOCTL, &values) != -1;
+    }
+
+    /**
+     * @brief releases bus, pull-up sets bus high
+     */
+    inline bool set_release()
+    {
+        gpio_v2_line_values values = { 0, 1 };
+        return ioctl(m_gpio.get_fd(), GPIO_V2_LINE_SET_VALUES_IOCTL, &values) != -1;
+    }
+
+    /**
+     * @brief reads bus level
+     * @returns 0: low, 1: high
+     */
+    inline uint8_t get()
+    {
+        gpio_v2_line_values values = { 0, 1 };
+        ioctl(m_gpio.get_fd(), GPIO_V2_LINE_GET_VALUES_IOCTL, &values);
+
+        // active low line
+        return (values.bits & 1) ? 0 : 1;
+    }
+
+    static constexpr ow_crc_table m_crc_table{}; // crc table
+
+    c_gpio m_gpio;         // bus gpio
+    c_timer m_timer;       // slot timing
+    optional<c_priority> m_priority; // priority of transaction
+    uint64_t m_bits;       // count of bit slots
+    int64_t m_bus_ns;      // bus time of transactions
+    int64_t m_begin_ns;    // start of actual transaction
+};
+
+/**
+ * @brief class c_onewire_multi
+ *
+ * 1-wire bus master on up to 64 buses in one line request,
+ * slots run on all buses at same time, bit n is n-th bus of init
+ * @note not thread-safe, lock in device driver
+ */
+class c_onewire_multi
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_onewire_multi()
+    {
+        m_bits = 0;
+        m_bus_ns = 0;
+        m_begin_ns = 0;
+    }
+
+    /**
+     * @brief inits bus gpio pins as open drain outputs, released
+     * @param chip pointer to chip
+     * @param pins bus pins (0..27)
+     * @param count count of buses 1..64
+     * @param print_msg flag for print error messages, true = on
+     * @returns true: ok, false: error
+     */
+    bool init(c_chip* chip, const uint32_t* pins, uint32_t count, bool print_msg = false)
+    {
+        m_lines.setchip(chip, print_msg);
+
+        // open drain, active low: 1 pulls bus low, 0 releases bus
+        return m_lines.init(pins, count, GPIO_MODE_OUTPUT_SINK, 0);
+    }
+
+    /**
+     * @brief returns count of buses
+     */
+    uint32_t get_count() { return m_lines.get_count(); }
+
+    /**
+     * @brief returns bit mask of all buses
+     */
+    uint64_t get_mask() { return m_lines.get_mask(); }
+
+    /**
+     * @brief returns error message
+     */
+    const char* get_error() { return m_lines.get_error(); }
+
+    /**
+     * @brief clears error message
+     */
+    void clear_error() { m_lines.clear_error(); }
+
+    /**
+     * @brief prints error message if enabled on stderr
+     * @param msg message to print
+     * @returns always false
+     */
+    bool print_error(const char* msg) { return m_lines.print_error(msg); }
+
+    /**
+     * @brief begins transaction, switch priority once for all slots
+     * @note uses default priority of actual thread
+     */
+    void begin()
+    {
+        if (m_priority)
+            return;
+
+        m_priority.emplace();
+        m_begin_ns = c_timer::now();
+    }
+
+    /**
+     * @brief ends transaction, restore priority
+     */
+    void end()
+    {
+        if (!m_priority)
+            return;
+
+        m_bus_ns += c_timer::now() - m_begin_ns;
+        m_priority.reset();
+    }
+
+    /**
+     * @brief resets buses
+     * @param mask selected buses
+     * @returns mask of buses with presence pulse
+     */
+    uint64_t reset(uint64_t mask)
+    {
+        if (m_lines.get_fd() == -1)
+        {
+            print_error("onewire: not init");
+            return 0;
+        }
+
+        int64_t t = c_timer::now();
+        uint64_t bits;
+
+        if (!m_lines.write(mask, mask))
+            return 0;
+
+        m_timer.delay_until(t + OW_RESET_LOW);
+        m_lines.write(0, mask);
+        m_timer.delay_until(t + OW_RESET_LOW + OW_RESET_SAMPLE);
+        m_lines.read(bits, mask);
+        m_timer.delay_until(t + OW_RESET_SLOT);
+
+        // devices pull bus low on presence, line is active low
+        return bits & mask;
+    }
+
+    /**
+     * @brief writes one bit slot on buses
+     * @param bits bit n is bit for n-th bus
+     * @param mask selected buses
+     */
+    void write_bit(uint64_t bits, uint64_t mask)
+    {
+        int64_t t = c_timer::now();
+
+        m_lines.write(mask, mask);
+        m_timer.delay_until(t + OW_WRITE1_LOW);
+
+        // release buses with 1 bit
+        m_lines.write(~bits & mask, mask);
+        m_timer.delay_until(t + OW_WRITE0_LOW);
+        m_lines.write(0, mask);
+        m_timer.delay_until(t + OW_SLOT);
+
+        m_bits += __builtin_popcountll(mask);
+    }
+
+    /**
+     * @brief reads one bit slot on buses
+     * @param mask selected buses
+     * @returns bit n is bit of n-th bus
+     */
+    uint64_t read_bit(uint64_t mask)
+    {
+        int64_t t = c_timer::now();
+        uint64_t bits;
+
+        m_lines.write(mask, mask);
+        m_timer.delay_until(t + OW_READ_LOW);
+        m_lines.write(0, mask);
+        m_timer.delay_until(t + OW_READ_SAMPLE);
+        m_lines.read(bits, mask);
+        m_timer.delay_until(t + OW_SLOT);
+
+        m_bits += __builtin_popcountll(mask);
+
+        // line is active low
+        return ~bits & mask;
+    }
+
+    /**
+     * @brief writes same byte on buses, lsb first
+     * @param byte data to write
+     * @param mask selected buses
+     */
+    void write_byte(uint8_t byte, uint64_t mask)
+    {
+        for (uint8_t i = 0; i < 8; i++)
+            write_bit(((byte >> i) & 1) ? mask : 0, mask);
+    }
+
+    /**
+     * @brief writes one byte on each bus, lsb first
+     * @param data data[n] is byte for n-th bus
+     * @param mask selected buses
+     */
+    void write_bytes(const uint8_t* data, uint64_t mask)
+    {
+        for (uint8_t i = 0; i < 8; i++)
+            write_bit(to_bits(data, 1, i, mask), mask);
+    }
+
+    /**
+     * @brief reads one byte on each bus, lsb first
+     * @param data data[n] receives byte of n-th bus
+     * @param mask selected buses
+     */
+    void read_bytes(uint8_t* data, uint64_t mask)
+    {
+        for (uint32_t n = 0; n < get_count(); n++)
+            data[n] = 0;
+
+        for (uint8_t i = 0; i < 8; i++)
+            from_bits(read_bit(mask), data, 1, i, mask);
+    }
+
+    /**
+     * @brief writes block on each bus
+     * @param data data[n * len] is block for n-th bus
+     * @param len length of block
+     * @param mask selected buses
+     */
+    void write_block(const uint8_t* data, uint8_t len, uint64_t mask)
+    {
+        for (uint8_t k = 0; k < len; k++)
+            for (uint8_t i = 0; i < 8; i++)
+                write_bit(to_bits(data + k, len, i, mask), mask);
+    }
+
+    /**
+     * @brief reads block on each bus
+     * @param data data[n * len] receives block of n-th bus
+     * @param len length of block
+     * @param mask selected buses
+     */
+    void read_block(uint8_t* data, uint8_t len, uint64_t mask)
+    {
+        memset(data, 0, size_t(len) * get_count());
+
+        for (uint8_t k = 0; k < len; k++)
+            for (uint8_t i = 0; i < 8; i++)
+                from_bits(read_bit(mask), data + k, len, i, mask);
+    }
+
+    /**
+     * @brief resets buses and selects device on each bus
+     * @param ids ids[n] is 64 bit rom id of n-th bus, NULL: skip rom (all devices)
+     * @param mask selected buses
+     * @returns mask of buses with presence pulse
+     */
+    uint64_t select(const ow_id* ids, uint64_t mask)
+    {
+        mask = reset(mask);
+
+        if (mask == 0)
+            return 0;
+
+        if (ids == NULL)
+            write_byte(OW_SKIP_ROM, mask);
+        else
+        {
+            write_byte(OW_MATCH_ROM, mask);
+            write_block((const uint8_t*) ids, 8, mask);
+        }
+
+        return mask;
+    }
+
+    /**
+     * @brief rom search on buses, one step
+     * @param cmd OW_SEARCH_ROM or OW_ALARM_SEARCH
+     * @param ids ids[n] is 64 bit rom id of n-th bus, last found id on input
+     * @param lastbits lastbits[n] is last discrepancy bit of n-th bus, 64 on start
+     * @param result result[n] of n-th bus, -2: repeat, -1: error, 0: no more devices, 1: device found
+     * @param mask selected buses
+     * @returns mask of buses with device found
+     */
+    uint64_t search(uint8_t cmd, ow_id* ids, int8_t* lastbits, int8_t* result, uint64_t mask)
+    {
+        return ow_search(*this, get_count(), cmd, ids, lastbits, result, mask);
+    }
+
+    /**
+     * @brief returns count of bit slots of all buses since start
+     */
+    uint64_t get_bits() { return m_bits; }
+
+    /**
+     * @brief returns bus throughput of transactions, sum of all buses
+     * @returns bits/s, 0 if no transaction
+     */
+    double get_bits_per_sec()
+    {
+        if (m_bus_ns == 0)
+            return 0.0;
+
+        return double(m_bits) * double(NSEC_PER_SEC) / double(m_bus_ns);
+    }
+
+    /**
+     * @brief clears throughput counter
+     */
+    void clear_stats()
+    {
+        m_bits = 0;
+        m_bus_ns = 0;
+    }
+
+private:
+    // collects bit i of data[n * stride] of each bus
+    uint64_t to_bits(const uint8_t* data, uint32_t stride, uint8_t i, uint64_t mask)
+    {
+        uint64_t bits = 0;
+
+        for (uint32_t n = 0; n < get_count(); n++)
+            if ((mask & (1ULL << n)) && ((data[n * stride] >> i) & 1))
+                bits |= 1ULL << n;
+
+        return bits;
+    }
+
+    // sets bit i of data[n * stride] of each bus
+    void from_bits(uint64_t bits, uint8_t* data, uint32_t stride, uint8_t i, uint64_t mask)
+    {
+        for (uint32_t n = 0; n < get_count(); n++)
+            if ((mask & bits & (1ULL << n)))
+                data[n * stride] |= (1 << i);
+    }
+
+    c_lines m_lines;       // bus gpios
+    c_timer m_timer;       // slot timing
+    optional<c_priority> m_priority; // priority of transaction
+    uint64_t m_bits;       // count of bit slots
+    int64_t m_bus_ns;      // bus time of transactions
+    int64_t m_begin_ns;    // start of actual transaction
+};
+
+/**
+ * @brief class c_ow_transaction
+ *
+ * begins transaction on create and ends on destroy
+ * @param BUS c_onewire or c_onewire_multi
+ */
+template <typename BUS>
+class c_ow_transaction
+{
+public:
+    /**
+     * @brief class constuctor
+     * @param bus 1-wire bus
+     */
+    c_ow_transaction(BUS& bus) : m_bus(bus)
+    {
+        m_bus.begin();
+    }
+
+    /**
+     * @brief class destructor
+     */
+    ~c_ow_transaction()
+    {
+        m_bus.end();
+    }
+
+private:
+    BUS& m_bus; // 1-wire bus
+};
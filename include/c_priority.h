@@ -9,7 +9,390 @@
 
 #pragma once
 
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <mutex>
+using namespace std;
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+// size of prefaulted stack
+#define RT_STACK_PREFAULT (64 * 1024)
+
+// select first isolated cpu
+#define RT_CPU_ISOLATED -2
+
+// no cpu pinning
+#define RT_CPU_NONE -1
+
+/**
+ * @brief priority policies
+ */
+enum {
+    PRIO_FIFO = 0, // SCHED_FIFO with priority
+    PRIO_RR,       // SCHED_RR with priority
+    PRIO_DEADLINE, // SCHED_DEADLINE with runtime, deadline and period
+};
+
+/**
+ * @brief priority parameter
+ */
+struct prio_param {
+    uint32_t policy;      // PRIO_..
+    uint32_t priority;    // FIFO/RR priority 1..99, 0: max. priority
+    uint64_t runtime_ns;  // DEADLINE: cpu time budget in each period
+    uint64_t deadline_ns; // DEADLINE: budget must be done within deadline, 0: period
+    uint64_t period_ns;   // DEADLINE: period
+};
+
+/**
+ * @brief kernel scheduling attributes (sched_setattr)
+ */
+struct prio_sched_attr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+/**
+ * @brief class c_sched
+ *
+ * get and set scheduling attributes of actual thread
+ */
+class c_sched
+{
+public:
+    /**
+     * @brief reads scheduling attributes of actual thread
+     * @param attr receives attributes
+     * @returns true: ok, false: error
+     */
+    static bool get(prio_sched_attr& attr)
+    {
+        memset(&attr, 0, sizeof(attr));
+        return syscall(SYS_sched_getattr, 0, &attr, sizeof(attr), 0) == 0;
+    }
+
+    /**
+     * @brief sets scheduling attributes of actual thread
+     * @param attr attributes
+     * @returns true: ok, false: error, see errno
+     */
+    static bool set(prio_sched_attr& attr)
+    {
+        attr.size = sizeof(attr);
+        return syscall(SYS_sched_setattr, 0, &attr, 0) == 0;
+    }
+
+    /**
+     * @brief converts priority parameter to scheduling attributes
+     * @param param priority parameter
+     * @param attr receives attributes
+     */
+    static void to_attr(const prio_param& param, prio_sched_attr& attr)
+    {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+
+        switch(param.policy)
+        {
+        case PRIO_DEADLINE:
+            attr.sched_policy = SCHED_DEADLINE;
+            attr.sched_runtime = param.runtime_ns;
+            attr.sched_deadline = (param.deadline_ns == 0) ? param.period_ns : param.deadline_ns;
+            attr.sched_period = param.period_ns;
+            break;
+
+        case PRIO_RR:
+            attr.sched_policy = SCHED_RR;
+            attr.sched_priority = (param.priority == 0) ? sched_get_priority_max(SCHED_RR) : param.priority;
+            break;
+
+        default:
+        case PRIO_FIFO:
+            attr.sched_policy = SCHED_FIFO;
+            attr.sched_priority = (param.priority == 0) ? sched_get_priority_max(SCHED_FIFO) : param.priority;
+            break;
+        }
+    }
+
+    /**
+     * @brief returns true if attributes are equal
+     */
+    static bool equal(const prio_sched_attr& a, const prio_sched_attr& b)
+    {
+        if (a.sched_policy != b.sched_policy)
+            return false;
+
+        if (a.sched_policy == SCHED_DEADLINE)
+            return (a.sched_runtime == b.sched_runtime) &&
+                   (a.sched_deadline == b.sched_deadline) &&
+                   (a.sched_period == b.sched_period);
+
+        return a.sched_priority == b.sched_priority;
+    }
+
+    /**
+     * @brief set default priority parameter of actual thread
+     * @param param priority parameter
+     * @note used by c_priority and c_rt_context without parameter
+     */
+    static void set_default(const prio_param& param)
+    {
+        t_param = param;
+    }
+
+    /**
+     * @brief returns default priority parameter of actual thread
+     */
+    static const prio_param& get_default()
+    {
+        return t_param;
+    }
+
+private:
+    static inline thread_local prio_param t_param = { PRIO_FIFO, 0, 0, 0, 0 }; // default of thread
+};
+
+/**
+ * @brief class c_rt_context
+ *
+ * real time context of thread, set up once:
+ * pins thread to cpu, locks memory, prefaults stack and switch policy once,
+ * c_priority does nothing while context is active
+ */
+class c_rt_context
+{
+public:
+    /**
+     * @brief class constuctor
+     * @param cpu cpu number, RT_CPU_ISOLATED: first isolated cpu, RT_CPU_NONE: no pinning
+     * @param lock_mem true: lock process memory with mlockall
+     * @param param priority parameter, NULL: default of thread
+     * @note SCHED_DEADLINE threads can not be pinned to one cpu
+     */
+    c_rt_context(int32_t cpu = RT_CPU_NONE, bool lock_mem = true, const prio_param* param = NULL)
+    {
+        m_param = (param == NULL) ? c_sched::get_default() : *param;
+        m_cpu = cpu;
+        m_lock_mem = lock_mem;
+        m_active = false;
+        m_pinned = false;
+        m_locked = false;
+        m_changed = false;
+    }
+
+    /**
+     * @brief leaves context on destroy
+     */
+    ~c_rt_context()
+    {
+        leave();
+    }
+
+    /**
+     * @brief enters real time context in actual thread
+     * @returns true: ok, false: error (e.g. no permission), see errno
+     * @note context is not active if policy can not be set
+     */
+    bool enter()
+    {
+        if (m_active)
+            return true;
+
+        // only one context per thread
+        if (t_active != NULL)
+            return false;
+
+        bool ok = true;
+
+        m_thread = pthread_self();
+
+        // pin thread to cpu
+        int32_t cpu = (m_cpu == RT_CPU_ISOLATED) ? isolated_cpu() : m_cpu;
+
+        if (cpu >= 0)
+        {
+            pthread_getaffinity_np(pthread_self(), sizeof(m_cpuset), &m_cpuset);
+
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpu, &cpuset);
+
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0)
+                m_pinned = true;
+            else
+                ok = false;
+        }
+
+        // lock memory, no page faults in time critical sections
+        if (m_lock_mem)
+        {
+            if (lock_memory())
+                m_locked = true;
+            else
+                ok = false;
+        }
+
+        prefault_stack();
+
+        // switch policy once, keep if already set
+        prio_sched_attr attr;
+        c_sched::to_attr(m_param, attr);
+
+        bool policy = c_sched::get(m_attr);
+
+        if (policy && !c_sched::equal(m_attr, attr))
+            policy = m_changed = c_sched::set(attr);
+
+        // c_priority must switch policy itself
+        if (!policy)
+        {
+            undo();
+            return false;
+        }
+
+        m_active = true;
+        t_active = this;
+
+        return ok;
+    }
+
+    /**
+     * @brief leaves real time context, restores policy and cpu affinity
+     * @note call in same thread as enter()
+     */
+    void leave()
+    {
+        if (!m_active)
+            return;
+
+        if (m_changed)
+            c_sched::set(m_attr);
+
+        undo();
+
+        m_changed = false;
+        m_active = false;
+
+        if (t_active == this)
+            t_active = NULL;
+    }
+
+    /**
+     * @brief returns true if actual thread runs in real time context
+     * @note no syscall
+     */
+    static inline bool active()
+    {
+        return t_active != NULL;
+    }
+
+    /**
+     * @brief returns first isolated cpu (kernel parameter isolcpus)
+     * @returns cpu number, -1: no isolated cpu
+     */
+    static int32_t isolated_cpu()
+    {
+        FILE* f = fopen("/sys/devices/system/cpu/isolated", "r");
+
+        if (f == NULL)
+            return -1;
+
+        int32_t cpu = -1;
+
+        // list format: 2-3,5
+        if (fscanf(f, "%d", &cpu) != 1)
+            cpu = -1;
+
+        fclose(f);
+
+        return cpu;
+    }
+
+private:
+    /**
+     * @brief restores cpu affinity and releases memory lock
+     */
+    void undo()
+    {
+        if (m_pinned)
+            pthread_setaffinity_np(m_thread, sizeof(m_cpuset), &m_cpuset);
+
+        if (m_locked)
+            unlock_memory();
+
+        m_pinned = false;
+        m_locked = false;
+    }
+
+    /**
+     * @brief locks process memory, counts contexts of all threads
+     * @returns true: ok, false: error
+     */
+    static bool lock_memory()
+    {
+        const lock_guard<mutex> lock(s_mtx);
+
+        if ((s_locks == 0) && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0))
+            return false;
+
+        s_locks++;
+
+        return true;
+    }
+
+    /**
+     * @brief unlocks process memory after last context of all threads
+     * @note munlockall is process wide
+     */
+    static void unlock_memory()
+    {
+        const lock_guard<mutex> lock(s_mtx);
+
+        if (--s_locks == 0)
+            munlockall();
+    }
+
+    /**
+     * @brief touches stack pages so they are mapped before time critical sections
+     */
+    static void __attribute__((noinline)) prefault_stack()
+    {
+        volatile uint8_t stack[RT_STACK_PREFAULT];
+
+        for (size_t i = 0; i < sizeof(stack); i += 4096)
+            stack[i] = 0;
+    }
+
+    int32_t m_cpu;         // cpu for pinning
+    bool m_lock_mem;       // lock memory flag
+    bool m_active;         // context active
+    bool m_pinned;         // thread pinned
+    bool m_locked;         // memory locked
+    bool m_changed;        // policy changed
+    prio_param m_param;    // priority parameter
+    prio_sched_attr m_attr; // saved scheduling attributes
+    cpu_set_t m_cpuset;    // saved cpu affinity
+    pthread_t m_thread;    // thread of context
+
+    static inline thread_local c_rt_context* t_active = NULL; // active context of thread
+    static inline mutex s_mtx;        // lock of memory lock count
+    static inline uint32_t s_locks = 0; // contexts with locked memory in process
+};
 
 /**
  * @brief class c_priority
@@ -18,13 +401,28 @@ class c_priority
 {
 public:
     /**
-     * @brief switch priority
+     * @brief switch priority with default parameter of thread
      * @param manual if true then use set/restore to switch
      */
     c_priority(bool manual = false)
     {
-        // save actual priority
-        sched_getparam(0, &m_sched);
+        m_changed = false;
+        m_param = c_sched::get_default();
+
+        // if not manual switch priority on create
+        if (!manual)
+            set();
+    }
+
+    /**
+     * @brief switch priority
+     * @param param priority parameter
+     * @param manual if true then use set/restore to switch
+     */
+    c_priority(const prio_param& param, bool manual = false)
+    {
+        m_changed = false;
+        m_param = param;
 
         // if not manual switch priority on create
         if (!manual)
@@ -41,23 +439,44 @@ public:
 
     /**
      * @brief switch priority manual
+     * @note does nothing in real time context or if already switched
      */
     void set()
     {
-        // set priority to FIFO
-        sched_param sched;
-        sched.sched_priority = sched_get_priority_max(SCHED_FIFO);
-        sched_setscheduler(0, SCHED_FIFO, &sched);
+        // no syscall in real time context
+        if (m_changed || c_rt_context::active())
+            return;
+
+        // save actual scheduling attributes
+        if (!c_sched::get(m_attr))
+            return;
+
+        prio_sched_attr attr;
+        c_sched::to_attr(m_param, attr);
+
+        // keep nested or already set priority
+        if (c_sched::equal(m_attr, attr))
+            return;
+
+        if (c_sched::set(attr))
+            m_changed = true;
     }
 
     /**
-     * @brief restore priority manual 
+     * @brief restore priority manual
      */
     void restore()
     {
-        sched_setscheduler(0, SCHED_OTHER, &m_sched);
+        if (!m_changed)
+            return;
+
+        // restore saved policy
+        c_sched::set(m_attr);
+        m_changed = false;
     }
 
 private:
-    sched_param m_sched; // save priority
+    prio_param m_param;     // priority parameter
+    prio_sched_attr m_attr; // saved scheduling attributes
+    bool m_changed;         // priority switched
 };
@@ -0,0 +1,491 @@
+/*
+ * lock-free bounded event queues and seqlock
+ *
+ * (c) Derya Y. iiot2k@gmail.com
+ *
+ * c_queue.h
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+using namespace std;
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+// cache line size
+#define CACHE_LINE 64
+
+/**
+ * @brief class c_wake
+ *
+ * eventfd based wakeup of consumer thread,
+ * write to eventfd only if consumer is waiting
+ */
+class c_wake
+{
+public:
+    /**
+     * @brief class constuctor
+     * @param enable true: create eventfd
+     */
+    c_wake(bool enable = false)
+    {
+        m_waiting = false;
+        m_fd = enable ? eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) : -1;
+    }
+
+    /**
+     * @brief class destructor
+     */
+    ~c_wake()
+    {
+        if (m_fd != -1)
+            close(m_fd);
+    }
+
+    /**
+     * @brief returns eventfd handle for poll, -1 if not enabled
+     */
+    inline int32_t get_fd() { return m_fd; }
+
+    /**
+     * @brief wakes consumer if waiting
+     * @note call after data is published
+     */
+    void notify()
+    {
+        if (m_fd == -1)
+            return;
+
+        // order publish of data before check of waiting flag
+        atomic_thread_fence(memory_order_seq_cst);
+
+        // write only if consumer waits
+        if (m_waiting.load(memory_order_relaxed) && m_waiting.exchange(false))
+        {
+            uint64_t val = 1;
+            ssize_t ret = ::write(m_fd, &val, sizeof(val));
+            (void) ret;
+        }
+    }
+
+    /**
+     * @brief consumer waits until notify or timeout
+     * @param empty function returns true if queue is empty
+     * @param timeout_ms timeout in ms, -1: wait forever
+     * @returns true: data available, false: timeout or not enabled
+     */
+    template <typename F>
+    bool wait(F empty, int32_t timeout_ms)
+    {
+        if (m_fd == -1)
+            return !empty();
+
+        m_waiting.store(true, memory_order_relaxed);
+
+        // order waiting flag before check of data
+        atomic_thread_fence(memory_order_seq_cst);
+
+        // check again after waiting flag is set
+        if (!empty())
+        {
+            m_waiting.store(false);
+            return true;
+        }
+
+        pollfd pfd = { .fd = m_fd, .events = POLLIN, .revents = 0 };
+
+        poll(&pfd, 1, timeout_ms);
+
+        m_waiting.store(false);
+
+        // clear eventfd counter
+        uint64_t val;
+        ssize_t ret = ::read(m_fd, &val, sizeof(val));
+        (void) ret;
+
+        return !empty();
+    }
+
+private:
+    int32_t m_fd;           // eventfd handle
+    atomic_bool m_waiting;  // consumer waits
+};
+
+/**
+ * @brief class c_spsc_queue
+ *
+ * bounded single producer, single consumer ring queue
+ * @param T element type (trivially copyable)
+ * @param SIZE count of elements, must be power of 2
+ */
+template <typename T, uint32_t SIZE>
+class c_spsc_queue
+{
+    static_assert((SIZE >= 2) && ((SIZE & (SIZE - 1)) == 0), "SIZE must be power of 2");
+
+public:
+    /**
+     * @brief class constuctor
+     * @param wake true: enable eventfd wakeup
+     */
+    c_spsc_queue(bool wake = false) : m_wake(wake)
+    {
+        m_head = 0;
+        m_tail = 0;
+        m_head_cache = 0;
+        m_tail_cache = 0;
+    }
+
+    /**
+     * @brief push one element (producer)
+     * @returns true: ok, false: queue full
+     */
+    bool push(const T& data)
+    {
+        return push(&data, 1) == 1;
+    }
+
+    /**
+     * @brief push multiple elements (producer)
+     * @param data elements to push
+     * @param n count of elements
+     * @returns count of pushed elements
+     */
+    uint32_t push(const T* data, uint32_t n)
+    {
+        uint32_t head = m_head.load(memory_order_relaxed);
+
+        // reload consumer position only if cached seems full
+        if (SIZE - (head - m_tail_cache) < n)
+            m_tail_cache = m_tail.load(memory_order_acquire);
+
+        uint32_t free = SIZE - (head - m_tail_cache);
+
+        if (n > free)
+            n = free;
+
+        for (uint32_t i = 0; i < n; i++)
+            m_data[(head + i) & (SIZE - 1)] = data[i];
+
+        if (n > 0)
+        {
+            m_head.store(head + n, memory_order_release);
+            m_wake.notify();
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief pop one element (consumer)
+     * @returns true: ok, false: queue empty
+     */
+    bool pop(T& data)
+    {
+        return pop(&data, 1) == 1;
+    }
+
+    /**
+     * @brief pop multiple elements (consumer)
+     * @param data receives elements
+     * @param n max. count of elements
+     * @returns count of popped elements
+     */
+    uint32_t pop(T* data, uint32_t n)
+    {
+        uint32_t tail = m_tail.load(memory_order_relaxed);
+
+        // reload producer position only if cached seems empty
+        if (m_head_cache - tail < n)
+            m_head_cache = m_head.load(memory_order_acquire);
+
+        uint32_t count = m_head_cache - tail;
+
+        if (n > count)
+            n = count;
+
+        for (uint32_t i = 0; i < n; i++)
+            data[i] = m_data[(tail + i) & (SIZE - 1)];
+
+        if (n > 0)
+            m_tail.store(tail + n, memory_order_release);
+
+        return n;
+    }
+
+    /**
+     * @brief waits until queue is not empty (consumer)
+     * @param timeout_ms timeout in ms, -1: wait forever
+     * @returns true: data available, false: timeout
+     * @note needs wake enabled on create
+     */
+    bool wait(int32_t timeout_ms = -1)
+    {
+        return m_wake.wait([this]() { return empty(); }, timeout_ms);
+    }
+
+    /**
+     * @brief returns eventfd handle for poll, -1 if wake not enabled
+     */
+    inline int32_t get_fd() { return m_wake.get_fd(); }
+
+    /**
+     * @brief returns true if queue is empty
+     */
+    bool empty() { return size() == 0; }
+
+    /**
+     * @brief returns count of elements in queue
+     */
+    uint32_t size()
+    {
+        return m_head.load(memory_order_acquire) - m_tail.load(memory_order_acquire);
+    }
+
+private:
+    alignas(CACHE_LINE) atomic_uint32_t m_head; // producer position
+    uint32_t m_tail_cache;                      // producer copy of consumer position
+    alignas(CACHE_LINE) atomic_uint32_t m_tail; // consumer position
+    uint32_t m_head_cache;                      // consumer copy of producer position
+    alignas(CACHE_LINE) T m_data[SIZE];         // ring buffer
+    c_wake m_wake;                              // consumer wakeup
+};
+
+/**
+ * @brief class c_mpsc_queue
+ *
+ * bounded multi producer, single consumer ring queue
+ * each slot has sequence number, producers reserve slots with CAS
+ * @param T element type (trivially copyable)
+ * @param SIZE count of elements, must be power of 2
+ */
+template <typename T, uint32_t SIZE>
+class c_mpsc_queue
+{
+    static_assert((SIZE >= 2) && ((SIZE & (SIZE - 1)) == 0), "SIZE must be power of 2");
+
+public:
+    /**
+     * @brief class constuctor
+     * @param wake true: enable eventfd wakeup
+     */
+    c_mpsc_queue(bool wake = false) : m_wake(wake)
+    {
+        for (uint32_t i = 0; i < SIZE; i++)
+            m_slot[i].seq.store(i, memory_order_relaxed);
+
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    /**
+     * @brief push one element (any producer)
+     * @returns true: ok, false: queue full
+     */
+    bool push(const T& data)
+    {
+        return push(&data, 1) == 1;
+    }
+
+    /**
+     * @brief push multiple elements (any producer)
+     * @param data elements to push
+     * @param n count of elements
+     * @returns count of pushed elements
+     * @note elements of one call are in sequence
+     */
+    uint32_t push(const T* data, uint32_t n)
+    {
+        uint32_t head = m_head.load(memory_order_relaxed);
+        uint32_t count;
+
+        // reserve slots, count of each try from requested count
+        do
+        {
+            uint32_t free = SIZE - (head - m_tail.load(memory_order_acquire));
+
+            if (free == 0)
+                return 0;
+
+            count = (n > free) ? free : n;
+
+        } while (!m_head.compare_exchange_weak(head, head + count, memory_order_relaxed));
+
+        // fill and publish slots
+        for (uint32_t i = 0; i < count; i++)
+        {
+            slot& s = m_slot[(head + i) & (SIZE - 1)];
+            s.data = data[i];
+            s.seq.store(head + i + 1, memory_order_release);
+        }
+
+        m_wake.notify();
+
+        return count;
+    }
+
+    /**
+     * @brief pop one element (consumer)
+     * @returns true: ok, false: queue empty
+     */
+    bool pop(T& data)
+    {
+        return pop(&data, 1) == 1;
+    }
+
+    /**
+     * @brief pop multiple elements (consumer)
+     * @param data receives elements
+     * @param n max. count of elements
+     * @returns count of popped elements
+     */
+    uint32_t pop(T* data, uint32_t n)
+    {
+        uint32_t tail = m_tail.load(memory_order_relaxed);
+        uint32_t i = 0;
+
+        // pop published slots in sequence
+        for (; i < n; i++)
+        {
+            slot& s = m_slot[(tail + i) & (SIZE - 1)];
+
+            if (s.seq.load(memory_order_acquire) != tail + i + 1)
+                break;
+
+            data[i] = s.data;
+            s.seq.store(tail + i + SIZE, memory_order_relaxed);
+        }
+
+        if (i > 0)
+            m_tail.store(tail + i, memory_order_release);
+
+        return i;
+    }
+
+    /**
+     * @brief waits until queue is not empty (consumer)
+     * @param timeout_ms timeout in ms, -1: wait forever
+     * @returns true: data available, false: timeout
+     * @note needs wake enabled on create
+     */
+    bool wait(int32_t timeout_ms = -1)
+    {
+        return m_wake.wait([this]() { return empty(); }, timeout_ms);
+    }
+
+    /**
+     * @brief returns eventfd handle for poll, -1 if wake not enabled
+     */
+    inline int32_t get_fd() { return m_wake.get_fd(); }
+
+    /**
+     * @brief returns true if next element is not published (consumer)
+     */
+    bool empty()
+    {
+        uint32_t tail = m_tail.load(memory_order_relaxed);
+        return m_slot[tail & (SIZE - 1)].seq.load(memory_order_acquire) != tail + 1;
+    }
+
+private:
+    // queue slot with sequence number
+    struct slot {
+        atomic_uint32_t seq;
+        T data;
+    };
+
+    alignas(CACHE_LINE) atomic_uint32_t m_head; // producers position
+    alignas(CACHE_LINE) atomic_uint32_t m_tail; // consumer position
+    alignas(CACHE_LINE) slot m_slot[SIZE];      // ring buffer
+    c_wake m_wake;                              // consumer wakeup
+};
+
+/**
+ * @brief class c_seqlock
+ *
+ * latest value of single writer for many readers without lock,
+ * readers retry if writer changed value while read
+ * @param T value type (trivially copyable)
+ */
+template <typename T>
+class c_seqlock
+{
+    static_assert(is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_seqlock()
+    {
+        m_seq = 0;
+
+        for (uint32_t i = 0; i < WORDS; i++)
+            m_data[i].store(0, memory_order_relaxed);
+    }
+
+    /**
+     * @brief stores value (single writer)
+     * @param data value to store
+     */
+    void store(const T& data)
+    {
+        uint64_t words[WORDS] = { 0 };
+        memcpy(words, &data, sizeof(T));
+
+        uint32_t seq = m_seq.load(memory_order_relaxed);
+
+        // odd sequence, write in progress
+        m_seq.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        for (uint32_t i = 0; i < WORDS; i++)
+            m_data[i].store(words[i], memory_order_relaxed);
+
+        // even sequence, value published
+        m_seq.store(seq + 2, memory_order_release);
+    }
+
+    /**
+     * @brief loads value (any reader)
+     * @param data receives value
+     * @returns sequence of value, 0: never stored
+     */
+    uint32_t load(T& data)
+    {
+        uint64_t words[WORDS];
+        uint32_t seq0, seq1;
+
+        do
+        {
+            seq0 = m_seq.load(memory_order_acquire);
+
+            for (uint32_t i = 0; i < WORDS; i++)
+                words[i] = m_data[i].load(memory_order_relaxed);
+
+            // order read of value before check of sequence
+            atomic_thread_fence(memory_order_acquire);
+            seq1 = m_seq.load(memory_order_relaxed);
+
+        } while ((seq0 & 1) || (seq0 != seq1));
+
+        memcpy(&data, words, sizeof(T));
+
+        return seq0 / 2;
+    }
+
+private:
+    // count of 64bit words of value
+    static constexpr uint32_t WORDS = (sizeof(T) + 7) / 8;
+
+    alignas(CACHE_LINE) atomic_uint32_t m_seq; // sequence, odd while write
+    atomic_uint64_t m_data[WORDS];             // value
+};
@@ -9,49 +9,179 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <algorithm>
+using namespace std;
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 #define NSEC_PER_SEC 1000000000l
 
-class c_timer
+// clock for all delays and sleeps, not changed by ntp steps
+#define TIMER_CLOCK CLOCK_MONOTONIC
+
+// default spin slice before calibration
+#define TIMER_SPIN_NS 100000l
+
+// calibration time of cycle counter
+#define CYCLES_CALIB_NS 10000000l
+
+/**
+ * @brief class c_cycles
+ *
+ * cpu cycle counter for short delays,
+ * x86: invariant TSC, arm64: generic timer counter
+ */
+class c_cycles
 {
 public:
-    c_timer() {}
-
     /**
-     * @brief delays current thread
-     * @param sec delay time in seconds
-     * @param nsec delay time in nano-seconds
-     * @note time is adjusted on overflow
-     * @note blocks current thread
+     * @brief returns true if cpu has invariant cycle counter
      */
-    void delay(int64_t sec, int64_t nsec)
+    static bool available()
     {
-        timespec ts;
-        ts.tv_sec = sec;
-        ts.tv_nsec = nsec;
+#if defined(__x86_64__) || defined(__i386__)
+        uint32_t eax, ebx, ecx, edx;
+
+        // invariant TSC: cpuid 0x80000007 edx bit 8
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+
+        return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
 
-        // adjust time on overflow
-        adj_time(ts);
+    /**
+     * @brief reads cycle counter
+     * @returns counter ticks, 0 if not available
+     */
+    static inline uint64_t read()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t val;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r" (val) :: "memory");
+        return val;
+#else
+        return 0;
+#endif
+    }
 
-        // get actual time
-        timespec ts_now;
-        clock_gettime(CLOCK_REALTIME, &ts_now);
+    /**
+     * @brief measures counter ticks per ns against CLOCK_MONOTONIC
+     * @param time_ns calibration time in ns
+     * @returns true: ok, false: counter not available
+     */
+    static bool calibrate(int64_t time_ns = CYCLES_CALIB_NS)
+    {
+        if (!available())
+            return false;
 
-        // calculate end time
-        ts.tv_sec =  ts_now.tv_sec + ts.tv_sec;
-        ts.tv_nsec = ts_now.tv_nsec + ts.tv_nsec;
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        int64_t t0 = int64_t(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+        uint64_t c0 = read();
 
-        // adjust time on overflow
-        adj_time(ts);
+        // spin calibration time
+        int64_t t1;
 
-        // wait until end time
         do
         {
-            clock_gettime(CLOCK_REALTIME, &ts_now);
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            t1 = int64_t(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+
+        } while (t1 - t0 < time_ns);
+
+        uint64_t c1 = read();
 
-        } while((ts_now.tv_sec < ts.tv_sec) || (ts_now.tv_nsec < ts.tv_nsec));
+        if (c1 <= c0)
+            return false;
+
+        m_ticks_per_ns.store(double(c1 - c0) / double(t1 - t0));
+
+        return true;
+    }
+
+    /**
+     * @brief returns counter ticks per ns, 0 if not calibrated
+     */
+    static inline double ticks_per_ns()
+    {
+        return m_ticks_per_ns.load(memory_order_relaxed);
+    }
+
+    /**
+     * @brief spins on cycle counter
+     * @param nsec delay time in ns
+     * @note call calibrate() before
+     */
+    static inline void delay_ns(int64_t nsec)
+    {
+        uint64_t end = read() + uint64_t(double(nsec) * ticks_per_ns());
+
+        while (read() < end);
+    }
+
+private:
+    static inline atomic<double> m_ticks_per_ns { 0.0 }; // counter ticks per ns
+};
+
+class c_timer
+{
+public:
+    /**
+     * @brief class constuctor
+     * @note calibrates spin slice on first create
+     */
+    c_timer()
+    {
+        static once_flag once;
+
+        call_once(once, []() { calibrate(); });
+    }
+
+    /**
+     * @brief returns actual time
+     * @returns time in ns (TIMER_CLOCK)
+     */
+    static inline int64_t now()
+    {
+        timespec ts;
+        clock_gettime(TIMER_CLOCK, &ts);
+        return int64_t(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+    }
+
+    /**
+     * @brief delays current thread
+     * @param sec delay time in seconds
+     * @param nsec delay time in nano-seconds
+     * @note sleeps most of time and spins last calibrated slice
+     * @note blocks current thread
+     */
+    void delay(int64_t sec, int64_t nsec)
+    {
+        // short delay on cycle counter
+        if ((sec == 0) && (nsec < spin_ns()) && m_cycles.load(memory_order_relaxed))
+            return c_cycles::delay_ns(nsec);
+
+        delay_until(now() + sec * NSEC_PER_SEC + nsec);
     }
 
     // delay functions for ns, us, ms and seconds
@@ -60,23 +190,32 @@ public:
     inline void delay_ms(int64_t msec) { delay(0l, msec * 1000000l); };
     inline void delay_s(int64_t sec)   { delay(sec, 0l); };
 
+    /**
+     * @brief delays current thread until deadline
+     * @param deadline_ns absolute time in ns (TIMER_CLOCK)
+     * @note use for sequences of delays without drift, deadline += period
+     * @note blocks current thread
+     */
+    void delay_until(int64_t deadline_ns)
+    {
+        int64_t spin = spin_ns();
+
+        // sleep until spin slice
+        if (deadline_ns - now() > spin)
+            sleep_abs(deadline_ns - spin);
+
+        // spin rest of time
+        while (now() < deadline_ns);
+    }
+
     /**
      * @brief sleeps current thread
      * @param sec sleep time in seconds
      * @param nsec sleep time in nano-seconds
-     * @note time is adjusted on overflow
      */
     void sleep(int64_t sec, int64_t nsec)
     {
-        timespec ts;
-        ts.tv_sec = sec;
-        ts.tv_nsec = nsec;
-
-        // adjust time on overflow
-        adj_time(ts);
-
-        // now sleep
-        nanosleep(&ts, NULL);
+        sleep_until(now() + sec * NSEC_PER_SEC + nsec);
     }
 
     // sleep functions for ns, us, ms and seconds
@@ -85,18 +224,319 @@ public:
     inline void sleep_ms(int64_t msec) { sleep(0l, msec * 1000000l); };
     inline void sleep_s(int64_t sec)   { sleep(sec, 0l); };
 
+    /**
+     * @brief sleeps current thread until deadline
+     * @param deadline_ns absolute time in ns (TIMER_CLOCK)
+     */
+    void sleep_until(int64_t deadline_ns)
+    {
+        sleep_abs(deadline_ns);
+    }
+
+    /**
+     * @brief measures wakeup latency of sleep and sets spin slice
+     * @param nloop count of measure loops
+     * @returns spin slice in ns
+     * @note called once on first create, call again after priority change
+     */
+    static int64_t calibrate(uint32_t nloop = 20)
+    {
+        int64_t max_late = 0;
+
+        for (uint32_t i = 0; i < nloop; i++)
+        {
+            int64_t t = now() + 50000l; // sleep 50us
+
+            sleep_abs(t);
+
+            int64_t late = now() - t;
+
+            if (late > max_late)
+                max_late = late;
+        }
+
+        // add 25% margin
+        int64_t spin = max_late + max_late / 4;
+
+        m_spin_ns.store(spin);
+
+        return spin;
+    }
+
+    /**
+     * @brief returns spin slice
+     * @returns time in ns
+     */
+    static inline int64_t spin_ns()
+    {
+        return m_spin_ns.load(memory_order_relaxed);
+    }
+
+    /**
+     * @brief switch delays shorter than spin slice to cycle counter
+     * @param enable true: use cycle counter, false: use clock_gettime
+     * @returns true if cycle counter is used
+     * @note counter is calibrated on enable, falls back to clock_gettime if counter is not invariant
+     */
+    static bool use_cycles(bool enable = true)
+    {
+        if (enable)
+            enable = c_cycles::calibrate();
+
+        m_cycles.store(enable);
+
+        return enable;
+    }
+
+private:
+    /**
+     * @brief sleeps until absolute time, continues on signal
+     * @param deadline_ns absolute time in ns (TIMER_CLOCK)
+     */
+    static void sleep_abs(int64_t deadline_ns)
+    {
+        timespec ts;
+        ts.tv_sec = deadline_ns / NSEC_PER_SEC;
+        ts.tv_nsec = deadline_ns % NSEC_PER_SEC;
+
+        while (clock_nanosleep(TIMER_CLOCK, TIMER_ABSTIME, &ts, NULL) == EINTR);
+    }
+
+    static inline atomic<int64_t> m_spin_ns { TIMER_SPIN_NS }; // spin slice
+    static inline atomic_bool m_cycles { false };              // use cycle counter
+};
+
+/**
+ * @brief timing statistics of periodic task
+ */
+struct timer_stats {
+    uint64_t count;     // count of periods
+    uint64_t overruns;  // count of missed periods
+    int64_t jitter_min; // min. wakeup latency in ns
+    int64_t jitter_max; // max. wakeup latency in ns
+    int64_t jitter_sum; // sum of wakeup latency in ns, mean = jitter_sum / count
+};
+
+/**
+ * @brief class c_periodic
+ *
+ * drift-free periodic wait with absolute deadlines
+ */
+class c_periodic
+{
+public:
+    /**
+     * @brief class constuctor
+     * @param period_ns period in ns
+     */
+    c_periodic(int64_t period_ns = 0)
+    {
+        m_period = period_ns;
+        start();
+    }
+
+    /**
+     * @brief set period
+     * @param period_ns period in ns
+     */
+    void set_period(int64_t period_ns)
+    {
+        m_period = period_ns;
+        start();
+    }
+
+    /**
+     * @brief starts period and clears statistics
+     * @param start_ns absolute start time in ns (TIMER_CLOCK), 0: now
+     */
+    void start(int64_t start_ns = 0)
+    {
+        m_next = ((start_ns == 0) ? c_timer::now() : start_ns) + m_period;
+        reset_stats();
+    }
+
+    /**
+     * @brief sleeps until next period
+     * @returns true: ok, false: overrun, missed periods are skipped
+     */
+    bool wait()
+    {
+        bool ok = true;
+
+        // work takes longer than period, skip missed periods
+        int64_t t = c_timer::now();
+
+        if ((m_period > 0) && (t >= m_next))
+        {
+            int64_t missed = (t - m_next) / m_period + 1;
+            m_stats.overruns += missed;
+            m_next += missed * m_period;
+            ok = false;
+        }
+
+        m_timer.sleep_until(m_next);
+
+        add_jitter(m_stats, c_timer::now() - m_next);
+
+        m_next += m_period;
+
+        return ok;
+    }
+
+    /**
+     * @brief returns timing statistics
+     */
+    const timer_stats& get_stats() { return m_stats; }
+
+    /**
+     * @brief clears timing statistics
+     */
+    void reset_stats()
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    /**
+     * @brief adds wakeup latency to statistics
+     * @param stats statistics
+     * @param jitter wakeup latency in ns
+     */
+    static void add_jitter(timer_stats& stats, int64_t jitter)
+    {
+        if ((stats.count == 0) || (jitter < stats.jitter_min))
+            stats.jitter_min = jitter;
+
+        if ((stats.count == 0) || (jitter > stats.jitter_max))
+            stats.jitter_max = jitter;
+
+        stats.jitter_sum += jitter;
+        stats.count++;
+    }
+
 private:
+    int64_t m_period;    // period in ns
+    int64_t m_next;      // next deadline in ns
+    timer_stats m_stats; // timing statistics
+    c_timer m_timer;     // timer
+};
+
+/**
+ * @brief class c_scheduler
+ *
+ * runs many periodic tasks in one thread,
+ * next task is taken from deadline heap
+ */
+class c_scheduler
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_scheduler()
+    {
+        m_stop = false;
+    }
+
+    /**
+     * @brief adds periodic task
+     * @param period_ns period in ns
+     * @param fn task function
+     * @param offset_ns first call after offset in ns
+     * @returns task id
+     * @note add tasks before run()
+     */
+    int32_t add(int64_t period_ns, function<void()> fn, int64_t offset_ns = 0)
+    {
+        c_task task;
+        task.period = period_ns;
+        task.next = c_timer::now() + offset_ns;
+        task.fn = fn;
+        memset(&task.stats, 0, sizeof(task.stats));
+
+        m_tasks.push_back(task);
+        m_heap.push_back(m_tasks.size() - 1);
+        push_heap(m_heap.begin(), m_heap.end(), compare());
+
+        return m_tasks.size() - 1;
+    }
+
     /**
-     * @brief adjust time on overflow
-     * @param ts time to adjust
+     * @brief runs tasks until stop() is called
+     * @note blocks current thread
      */
-    inline void adj_time(timespec &ts)
+    void run()
     {
-        // if overflow adjust time
-        while(ts.tv_nsec >= NSEC_PER_SEC)
+        m_stop = false;
+
+        while(!m_stop && !m_heap.empty())
         {
-            ts.tv_sec++;
-            ts.tv_nsec -= NSEC_PER_SEC;
+            // task with earliest deadline
+            pop_heap(m_heap.begin(), m_heap.end(), compare());
+            c_task& task = m_tasks[m_heap.back()];
+
+            m_timer.sleep_until(task.next);
+
+            c_periodic::add_jitter(task.stats, c_timer::now() - task.next);
+
+            task.fn();
+
+            // next deadline, skip missed periods
+            task.next += task.period;
+
+            int64_t t = c_timer::now();
+
+            if ((task.period > 0) && (t >= task.next))
+            {
+                int64_t missed = (t - task.next) / task.period + 1;
+                task.stats.overruns += missed;
+                task.next += missed * task.period;
+            }
+
+            push_heap(m_heap.begin(), m_heap.end(), compare());
         }
     }
+
+    /**
+     * @brief stops run() after actual task
+     */
+    void stop()
+    {
+        m_stop = true;
+    }
+
+    /**
+     * @brief returns timing statistics of task
+     * @param id task id
+     * @param stats receives statistics
+     * @returns true: ok, false: invalid id
+     */
+    bool get_stats(int32_t id, timer_stats& stats)
+    {
+        if ((id < 0) || (id >= (int32_t) m_tasks.size()))
+            return false;
+
+        stats = m_tasks[id].stats;
+
+        return true;
+    }
+
+private:
+    // periodic task
+    struct c_task {
+        int64_t period;     // period in ns
+        int64_t next;       // next deadline in ns
+        function<void()> fn; // task function
+        timer_stats stats;  // timing statistics
+    };
+
+    // heap order, earliest deadline on top
+    function<bool(uint32_t, uint32_t)> compare()
+    {
+        return [this](uint32_t a, uint32_t b) { return m_tasks[a].next > m_tasks[b].next; };
+    }
+
+    vector<c_task> m_tasks;  // tasks
+    vector<uint32_t> m_heap; // deadline heap of task index
+    atomic_bool m_stop;      // stop flag
+    c_timer m_timer;         // timer
 };
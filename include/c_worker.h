@@ -10,8 +10,21 @@
 #pragma once
 
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
 using namespace std;
 
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+class c_pool;
+
 /**
  * @brief class c_worker
  */
@@ -44,6 +57,14 @@ public:
             th.detach();
     }
 
+    /**
+     * @brief run in thread pool
+     * @param pool thread pool
+     * @returns future, ready if Execute() ends, invalid future after join() of pool
+     * @note class is deleted by pool after Execute(), not deleted if future is invalid
+     */
+    future<void> Queue(c_pool& pool);
+
 private:
     /**
      * @brief main execute function
@@ -54,3 +75,231 @@ private:
         delete this; // harakiri class
     }
 };
+
+/**
+ * @brief class c_pool
+ *
+ * fixed pool of worker threads, each thread has own task deque,
+ * idle threads steal tasks from other deques
+ */
+class c_pool
+{
+public:
+    /**
+     * @brief creates pool threads
+     * @param nthread count of threads, 0: count of cpus
+     * @param cpus cpu list for thread affinity, thread n runs on cpus[n % size], empty: no affinity
+     * @note thread with invalid cpu number has no affinity
+     */
+    c_pool(uint32_t nthread = 0, const vector<int32_t>& cpus = {})
+    {
+        if (nthread == 0)
+            nthread = thread::hardware_concurrency();
+
+        if (nthread == 0)
+            nthread = 1;
+
+        m_stop = false;
+        m_pending = 0;
+        m_next = 0;
+
+        for (uint32_t i = 0; i < nthread; i++)
+            m_queues.emplace_back(new c_deque);
+
+        // valid cpu numbers
+        int32_t ncpu = (int32_t) sysconf(_SC_NPROCESSORS_CONF);
+
+        if ((ncpu <= 0) || (ncpu > CPU_SETSIZE))
+            ncpu = CPU_SETSIZE;
+
+        for (uint32_t i = 0; i < nthread; i++)
+        {
+            int32_t cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+
+            // thread sets own affinity before first task
+            m_threads.emplace_back(&c_pool::execute, this, i, ((cpu >= 0) && (cpu < ncpu)) ? cpu : -1);
+        }
+    }
+
+    /**
+     * @brief stops pool on destroy
+     */
+    ~c_pool()
+    {
+        join();
+    }
+
+    /**
+     * @brief returns count of threads
+     */
+    uint32_t size() { return m_queues.size(); }
+
+    /**
+     * @brief queue worker
+     * @param worker worker to execute, deleted after Execute()
+     * @returns future, ready if Execute() ends,
+     *          invalid future (valid() is false) after join(), worker is not deleted
+     * @note workers of pool threads are queued until pool threads end
+     */
+    future<void> Queue(c_worker* worker)
+    {
+        c_task task;
+        task.worker = worker;
+
+        // own deque if called from pool thread, otherwise round robin
+        uint32_t idx = (t_pool == this) ? t_index : (m_next++ % size());
+
+        const lock_guard<mutex> lock(m_mtx);
+
+        // pool threads may end before worker is executed
+        if (m_stop && (t_pool != this))
+            return future<void>();
+
+        future<void> ret = task.done.get_future();
+
+        {
+            const lock_guard<mutex> lock_deque(m_queues[idx]->mtx);
+            m_queues[idx]->tasks.push_back(move(task));
+        }
+
+        m_pending++;
+
+        m_cv.notify_one();
+
+        return ret;
+    }
+
+    /**
+     * @brief executes queued workers and ends threads
+     * @note blocks until all threads ends
+     */
+    void join()
+    {
+        {
+            const lock_guard<mutex> lock(m_mtx);
+            m_stop = true;
+        }
+
+        m_cv.notify_all();
+
+        for (thread& th: m_threads)
+            if (th.joinable())
+                th.join();
+    }
+
+private:
+    // queued worker
+    struct c_task {
+        c_worker* worker;
+        promise<void> done;
+    };
+
+    // task deque of one thread
+    struct c_deque {
+        mutex mtx;
+        deque<c_task> tasks;
+    };
+
+    /**
+     * @brief get task from own deque or steal from other deque
+     * @param idx thread index
+     * @param task receives task
+     * @returns true: task found
+     */
+    bool pop(uint32_t idx, c_task& task)
+    {
+        uint32_t n = size();
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            c_deque* q = m_queues[(idx + i) % n].get();
+            const lock_guard<mutex> lock(q->mtx);
+
+            if (q->tasks.empty())
+                continue;
+
+            // own deque from back, steal from front
+            if (i == 0)
+            {
+                task = move(q->tasks.back());
+                q->tasks.pop_back();
+            }
+            else
+            {
+                task = move(q->tasks.front());
+                q->tasks.pop_front();
+            }
+
+            m_pending--;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief main function of pool thread
+     * @param idx thread index
+     * @param cpu cpu for thread affinity, -1: no affinity
+     */
+    void execute(uint32_t idx, int32_t cpu)
+    {
+        t_pool = this;
+        t_index = idx;
+
+        // set cpu affinity
+        if (cpu >= 0)
+        {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpu, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        }
+
+        while(1)
+        {
+            c_task task;
+
+            if (pop(idx, task))
+            {
+                try
+                {
+                    task.worker->Execute();
+                    delete task.worker;
+                    task.done.set_value();
+                }
+                catch(...)
+                {
+                    delete task.worker;
+                    task.done.set_exception(current_exception());
+                }
+
+                continue;
+            }
+
+            // wait for task or stop
+            unique_lock<mutex> lock(m_mtx);
+            m_cv.wait(lock, [this]() { return m_stop || (m_pending > 0); });
+
+            if (m_stop && (m_pending <= 0))
+                break;
+        }
+    }
+
+    vector<thread> m_threads;            // pool threads
+    vector<unique_ptr<c_deque>> m_queues; // task deque per thread
+    mutex m_mtx;                         // lock for wait
+    condition_variable m_cv;             // wakes idle threads
+    atomic_int32_t m_pending;            // count of queued tasks
+    atomic_uint32_t m_next;              // next deque for round robin
+    bool m_stop;                         // stop flag
+
+    static inline thread_local c_pool* t_pool = NULL; // pool of actual thread
+    static inline thread_local uint32_t t_index = 0;  // index of actual thread
+};
+
+inline future<void> c_worker::Queue(c_pool& pool)
+{
+    return pool.Queue(this);
+}
@@ -18,6 +18,7 @@ using namespace std;
 #include <sys/ioctl.h>
 #include <string.h>
 #include <poll.h>
+#include <time.h>
 
 #include "gpio.h"
 
@@ -47,6 +48,321 @@ enum {
     GPIO_EDGE_NONE,       // no edge
 };
 
+// count of kernel events read with one call
+#define GPIO_EVENT_BATCH 16
+
+/**
+ * @brief gpio event
+ */
+struct gpio_event {
+    uint64_t timestamp_ns; // event time in ns (CLOCK_MONOTONIC)
+    uint32_t pin;          // gpio pin
+    uint32_t edge;         // GPIO_EDGE_RISING or GPIO_EDGE_FALLING
+};
+
+/**
+ * @brief returns line flags of gpio mode, used by c_gpio and c_lines
+ * @param mode gpio mode GPIO_MODE_..
+ * @returns line flags, 0 if invalid mode
+ */
+static inline uint64_t gpio_mode_flags(uint32_t mode)
+{
+    switch(mode)
+    {
+    case GPIO_MODE_INPUT:
+        return GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_DISABLED;
+    case GPIO_MODE_INPUT_PULLDOWN:
+        return GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+    case GPIO_MODE_INPUT_PULLUP:
+        return GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_PULL_UP + GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    case GPIO_MODE_OUTPUT:
+        return GPIO_V2_LINE_FLAG_OUTPUT;
+    case GPIO_MODE_OUTPUT_SOURCE:
+        return GPIO_V2_LINE_FLAG_OUTPUT + GPIO_V2_LINE_FLAG_OPEN_SOURCE;
+    case GPIO_MODE_OUTPUT_SINK:
+        return GPIO_V2_LINE_FLAG_OUTPUT + GPIO_V2_LINE_FLAG_OPEN_DRAIN + GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief returns line flags of edge mode, used by c_gpio and c_lines
+ * @param edge edge mode GPIO_EDGE_..
+ * @returns line flags, 0 if no edge
+ */
+static inline uint64_t gpio_edge_flags(uint32_t edge)
+{
+    switch(edge)
+    {
+    case GPIO_EDGE_RISING:
+        return GPIO_V2_LINE_FLAG_EDGE_RISING;
+    case GPIO_EDGE_FALLING:
+        return GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    case GPIO_EDGE_BOTH:
+        return GPIO_V2_LINE_FLAG_EDGE_RISING + GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief userspace event filter parameter
+ * all times in us, 0: stage off
+ */
+struct gpio_filter {
+    uint32_t min_pulse_us; // pulses shorter than this are dropped (glitch)
+    uint32_t debounce_us;  // level must be quiet for this time before reported
+    uint32_t holdoff_us;   // edges after a reported edge are ignored for this time
+};
+
+/**
+ * @brief class c_filter
+ *
+ * filters timestamped gpio events in userspace
+ * stages: glitch -> debounce -> hold-off -> edge select
+ */
+class c_filter
+{
+public:
+    /**
+     * @brief class constuctor
+     */
+    c_filter()
+    {
+        memset(&m_param, 0, sizeof(m_param));
+        m_edge = GPIO_EDGE_BOTH;
+        reset();
+    }
+
+    /**
+     * @brief set filter parameter
+     * @param param filter parameter
+     * @param edge reported edges GPIO_EDGE_..
+     */
+    void set(const gpio_filter& param, uint32_t edge = GPIO_EDGE_BOTH)
+    {
+        m_param = param;
+        m_edge = edge;
+        reset();
+    }
+
+    /**
+     * @brief set reported edges
+     * @param edge reported edges GPIO_EDGE_..
+     */
+    void set_edge(uint32_t edge)
+    {
+        m_edge = edge;
+        reset();
+    }
+
+    /**
+     * @brief returns true if any filter stage is on
+     */
+    bool enabled()
+    {
+        return (m_param.min_pulse_us != 0) || (m_param.debounce_us != 0) || (m_param.holdoff_us != 0);
+    }
+
+    /**
+     * @brief resets filter state
+     */
+    void reset()
+    {
+        m_glitch_valid = false;
+        m_burst_valid = false;
+        m_accept_valid = false;
+        m_level = -1;
+    }
+
+    /**
+     * @brief filters batch of events
+     * @param ev events in time order
+     * @param n count of events
+     * @param out receives accepted events, may be same as ev
+     * @returns count of accepted events (0..n)
+     */
+    uint32_t process(const gpio_event* ev, uint32_t n, gpio_event* out)
+    {
+        uint32_t nout = 0;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            gpio_event e = ev[i];
+            glitch(e, out, nout);
+        }
+
+        return nout;
+    }
+
+    /**
+     * @brief releases pending events which deadline has passed
+     * @param now_ns actual time in ns (CLOCK_MONOTONIC)
+     * @param out receives accepted events, size min. 2
+     * @returns count of accepted events (0..2)
+     */
+    uint32_t flush(uint64_t now_ns, gpio_event* out)
+    {
+        uint32_t nout = 0;
+
+        // glitch stage: level held long enough
+        if (m_glitch_valid && (now_ns - m_glitch.timestamp_ns >= us(m_param.min_pulse_us)))
+        {
+            m_glitch_valid = false;
+            debounce(m_glitch, out, nout);
+        }
+
+        // debounce stage: line is quiet
+        if (m_burst_valid && (now_ns - m_burst_last_ns >= us(m_param.debounce_us)))
+            settle(out, nout);
+
+        return nout;
+    }
+
+    /**
+     * @brief returns time of next pending deadline
+     * @returns time in ns (CLOCK_MONOTONIC), 0: nothing pending
+     */
+    uint64_t deadline()
+    {
+        uint64_t t = 0;
+
+        if (m_glitch_valid)
+            t = m_glitch.timestamp_ns + us(m_param.min_pulse_us);
+
+        if (m_burst_valid)
+        {
+            uint64_t t_burst = m_burst_last_ns + us(m_param.debounce_us);
+
+            if ((t == 0) || (t_burst < t))
+                t = t_burst;
+        }
+
+        return t;
+    }
+
+private:
+    inline uint64_t us(uint32_t usec) { return uint64_t(usec) * 1000ull; }
+
+    /**
+     * @brief glitch stage, drops pulse pairs shorter than min. pulse
+     */
+    void glitch(gpio_event& e, gpio_event* out, uint32_t& nout)
+    {
+        if (m_param.min_pulse_us == 0)
+        {
+            debounce(e, out, nout);
+            return;
+        }
+
+        if (m_glitch_valid)
+        {
+            // pulse too short, drop both edges
+            if (e.timestamp_ns - m_glitch.timestamp_ns < us(m_param.min_pulse_us))
+            {
+                m_glitch_valid = false;
+                return;
+            }
+
+            // pending edge held long enough
+            debounce(m_glitch, out, nout);
+        }
+
+        m_glitch = e;
+        m_glitch_valid = true;
+    }
+
+    /**
+     * @brief debounce stage, reports settled level after quiet time
+     */
+    void debounce(gpio_event& e, gpio_event* out, uint32_t& nout)
+    {
+        if (m_param.debounce_us == 0)
+        {
+            holdoff(e, out, nout);
+            return;
+        }
+
+        // edge in burst
+        if (m_burst_valid && (e.timestamp_ns - m_burst_last_ns < us(m_param.debounce_us)))
+        {
+            m_burst_last_ns = e.timestamp_ns;
+            m_burst_edge = e.edge;
+            return;
+        }
+
+        // previous burst is settled
+        if (m_burst_valid)
+            settle(out, nout);
+
+        // start new burst
+        m_burst = e;
+        m_burst_last_ns = e.timestamp_ns;
+        m_burst_edge = e.edge;
+        m_burst_valid = true;
+    }
+
+    /**
+     * @brief ends burst and reports level if changed
+     * @note timestamp is first edge of burst
+     */
+    void settle(gpio_event* out, uint32_t& nout)
+    {
+        m_burst_valid = false;
+
+        int32_t level = (m_burst_edge == GPIO_EDGE_RISING) ? 1 : 0;
+
+        if (level == m_level)
+            return;
+
+        gpio_event e = m_burst;
+        e.edge = m_burst_edge;
+
+        // level changes only with edge passed hold-off, also if edge is not selected
+        if (holdoff(e, out, nout))
+            m_level = level;
+    }
+
+    /**
+     * @brief hold-off stage, ignores edges after reported edge
+     * @returns false: edge dropped by hold-off
+     */
+    bool holdoff(gpio_event& e, gpio_event* out, uint32_t& nout)
+    {
+        if (m_param.holdoff_us != 0)
+        {
+            if (m_accept_valid && (e.timestamp_ns - m_accept_ns < us(m_param.holdoff_us)))
+                return false;
+
+            m_accept_ns = e.timestamp_ns;
+            m_accept_valid = true;
+        }
+
+        // edge select
+        if ((m_edge == GPIO_EDGE_BOTH) || (m_edge == e.edge))
+            out[nout++] = e;
+
+        return true;
+    }
+
+    gpio_filter m_param;      // filter parameter
+    uint32_t m_edge;          // reported edges
+
+    gpio_event m_glitch;      // pending edge of glitch stage
+    bool m_glitch_valid;      // glitch edge pending
+
+    gpio_event m_burst;       // first edge of burst
+    uint64_t m_burst_last_ns; // time of last edge in burst
+    uint32_t m_burst_edge;    // last edge in burst
+    bool m_burst_valid;       // burst pending
+
+    uint64_t m_accept_ns;     // time of last reported edge
+    bool m_accept_valid;      // edge reported
+
+    int32_t m_level;          // reported level, -1: unknown
+};
+
 /**
  * @brief class c_chip
  * 
@@ -103,6 +419,8 @@ public:
         m_fd = -1;
         m_print_msg = false;
         m_chip = NULL;
+        m_evt_pos = 0;
+        m_evt_cnt = 0;
     }
 
     /**
@@ -114,6 +432,8 @@ public:
     {
         m_pin = -1;
         m_fd = -1;
+        m_evt_pos = 0;
+        m_evt_cnt = 0;
         setchip(chip, print_msg);
     }
 
@@ -146,6 +466,18 @@ public:
             close(m_fd);
         m_pin = -1;
         m_fd = -1;
+        m_evt_pos = 0;
+        m_evt_cnt = 0;
+    }
+
+    /**
+     * @brief set userspace event filter
+     * @param param filter parameter, all zero turns filter off
+     * @note call before init(), edge of init() selects reported edges
+     */
+    void set_filter(const gpio_filter& param)
+    {
+        m_filter.set(param);
     }
 
     /**
@@ -154,6 +486,13 @@ public:
      */
     int32_t get_pin() { return m_pin; }
 
+    /**
+     * @brief returns gpio line handle
+     * @returns handle, -1 if not init
+     * @note for direct ioctl in time critical drivers, no lock
+     */
+    inline int32_t get_fd() { return m_fd; }
+
     /**
      * @brief clears message buffer
      */
@@ -221,6 +560,12 @@ public:
         // close gpio
         deinit();
 
+        // filter needs both edges for level tracking
+        m_filter.set_edge(edge);
+
+        if (m_filter.enabled() && (edge != GPIO_EDGE_NONE))
+            edge = GPIO_EDGE_BOTH;
+
         // init line request
         gpio_v2_line_request line_request;
 
@@ -230,43 +575,17 @@ public:
         line_request.offsets[0] = pin;
 
         // set gpio configuration
-        switch(mode)
-        {
-        case GPIO_MODE_INPUT:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_DISABLED;
-            set_line_debounce_us(line_request.config, setval);
-            set_edge_value(line_request.config, edge);
-            break;
-
-        case GPIO_MODE_INPUT_PULLDOWN:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
-            set_line_debounce_us(line_request.config, setval);
-            set_edge_value(line_request.config, edge);
-            break;
-
-        case GPIO_MODE_INPUT_PULLUP:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_INPUT + GPIO_V2_LINE_FLAG_BIAS_PULL_UP + GPIO_V2_LINE_FLAG_ACTIVE_LOW;
-            set_line_debounce_us(line_request.config, setval);
-            set_edge_value(line_request.config, edge);
-            break;
+        line_request.config.flags = gpio_mode_flags(mode);
 
-        case GPIO_MODE_OUTPUT:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
-            set_line_value(line_request.config, setval);
-            break;
-
-        case GPIO_MODE_OUTPUT_SOURCE:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT + GPIO_V2_LINE_FLAG_OPEN_SOURCE;
-            set_line_value(line_request.config, setval);
-            break;
+        if (line_request.config.flags == 0)
+            return print_error("gpiox: invalid mode");
 
-        case GPIO_MODE_OUTPUT_SINK:
-            line_request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT + GPIO_V2_LINE_FLAG_OPEN_DRAIN + GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+        if (line_request.config.flags & GPIO_V2_LINE_FLAG_OUTPUT)
             set_line_value(line_request.config, setval);
-            break;
-
-        default:
-            return print_error("gpiox: invalid mode");
+        else
+        {
+            set_line_debounce_us(line_request.config, setval);
+            line_request.config.flags += gpio_edge_flags(edge);
         }
 
         // init gpio pin
@@ -378,62 +697,177 @@ public:
      * @returns true: valid gpio event, false: error
      */
     bool watch(uint32_t& edge)
+    {
+        gpio_event event;
+
+        // wait for one event
+        if (watch(&event, 1) != 1)
+            return false;
+
+        edge = event.edge;
+
+        return true;
+    }
+
+    /**
+     * @brief watch gpio for changes, reads events in batch
+     * @param events receives events
+     * @param size max. count of events
+     * @param timeout_ms timeout in ms, -1: wait forever
+     * @returns count of events, 0: timeout, -1: error
+     * @note events pass userspace filter if set
+     */
+    int32_t watch(gpio_event* events, uint32_t size, int32_t timeout_ms = -1)
     {
         // clear error
         clear_error();
 
         if (m_pin == -1)
-            return print_error("gpiox: not init");
+        {
+            print_error("gpiox: not init");
+            return -1;
+        }
 
-        // event data
-        gpio_v2_line_event event_data;
+        if ((events == NULL) || (size == 0))
+        {
+            print_error("gpiox: invalid parameter");
+            return -1;
+        }
+
+        // return buffered events first
+        if (m_evt_pos < m_evt_cnt)
+            return copy_events(events, size);
+
+        // calculate end time
+        uint64_t end_ns = 0;
+
+        if (timeout_ms >= 0)
+            end_ns = now_ns() + uint64_t(timeout_ms) * 1000000ull;
 
         // poll data
         pollfd pfd = { .fd = m_fd, .events = POLLIN, .revents = 0 };
 
         while(1)
         {
+            // wait until next filter deadline or timeout
+            uint64_t wait_ns = m_filter.deadline();
+
+            if ((end_ns != 0) && ((wait_ns == 0) || (end_ns < wait_ns)))
+                wait_ns = end_ns;
+
+            timespec ts;
+            timespec* pts = NULL;
+
+            if (wait_ns != 0)
+            {
+                uint64_t now = now_ns();
+                uint64_t diff = (wait_ns > now) ? wait_ns - now : 0;
+                ts.tv_sec = diff / 1000000000ull;
+                ts.tv_nsec = diff % 1000000000ull;
+                pts = &ts;
+            }
+
             // wait for event
-            if (poll(&pfd, 1, -1) <= 0)
-                return print_error();
+            int32_t ret = ppoll(&pfd, 1, pts, NULL);
+
+            if (ret < 0)
+            {
+                print_error();
+                return -1;
+            }
+
+            // timeout
+            if (ret == 0)
+            {
+                uint64_t now = now_ns();
+
+                // release pending filter events
+                m_evt_pos = 0;
+                m_evt_cnt = m_filter.flush(now, m_evt);
+
+                if (m_evt_cnt > 0)
+                    return copy_events(events, size);
+
+                if ((end_ns != 0) && (now >= end_ns))
+                    return 0;
+
+                continue;
+            }
 
             // read event data
-            int32_t ret = ::read(m_fd, &event_data, sizeof(event_data));
+            ssize_t len = ::read(m_fd, m_raw, sizeof(m_raw));
 
             // check return code
-            if (ret == -1)
+            if (len == -1)
             {
                 // read again
-                if (errno == -EAGAIN)
+                if (errno == EAGAIN)
                     continue;
-                else
-                    return print_error();
+
+                print_error();
+                return -1;
             }
 
             // check if read all data
-            if (ret != sizeof(event_data))
-                return print_error();
+            if ((len == 0) || (len % sizeof(gpio_v2_line_event) != 0))
+            {
+                print_error("gpiox: invalid event data");
+                return -1;
+            }
 
-            break;
-        }
+            uint32_t n = len / sizeof(gpio_v2_line_event);
 
-        // set event edge
-        switch(event_data.id)
-        {
-        case GPIO_V2_LINE_EVENT_RISING_EDGE:
-            edge = GPIO_EDGE_RISING;
-            break;
-        case GPIO_V2_LINE_EVENT_FALLING_EDGE:
-            edge = GPIO_EDGE_FALLING;
-            break;
-        default:
-            edge = GPIO_EDGE_NONE;
-        }
+            // convert kernel events
+            for (uint32_t i = 0; i < n; i++)
+            {
+                m_evt[i].timestamp_ns = m_raw[i].timestamp_ns;
+                m_evt[i].pin = m_pin;
+
+                switch(m_raw[i].id)
+                {
+                case GPIO_V2_LINE_EVENT_RISING_EDGE:
+                    m_evt[i].edge = GPIO_EDGE_RISING;
+                    break;
+                case GPIO_V2_LINE_EVENT_FALLING_EDGE:
+                    m_evt[i].edge = GPIO_EDGE_FALLING;
+                    break;
+                default:
+                    m_evt[i].edge = GPIO_EDGE_NONE;
+                }
+            }
 
-        return true;
+            // filter events in place
+            m_evt_pos = 0;
+            m_evt_cnt = m_filter.enabled() ? m_filter.process(m_evt, n, m_evt) : n;
+
+            if (m_evt_cnt > 0)
+                return copy_events(events, size);
+        }
     }
 
 private:
+    // returns monotonic time in ns
+    uint64_t now_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+    }
+
+    // copy buffered events
+    int32_t copy_events(gpio_event* events, uint32_t size)
+    {
+        uint32_t n = m_evt_cnt - m_evt_pos;
+
+        if (n > size)
+            n = size;
+
+        memcpy(events, &m_evt[m_evt_pos], n * sizeof(gpio_event));
+        m_evt_pos += n;
+
+        return n;
+    }
+
     // set debounce parameter
     void set_line_debounce_us(gpio_v2_line_config& line_config, uint32_t debounce)
     {
@@ -452,31 +886,402 @@ private:
         line_config.attrs[0].attr.values = setval > 0 ? 1 : 0;
     }
 
-    // set edge parameter
-    void set_edge_value(gpio_v2_line_config& line_config, uint32_t edge)
+    c_chip* m_chip;   // chip
+    int32_t m_pin;    // gpio pin
+    int32_t m_fd;     // gpio pin handle
+    bool m_print_msg; // flag for print message
+    string m_msg;     // store for messages
+    mutex m_mtx;      // lock mutex
+
+    c_filter m_filter; // userspace event filter
+    gpio_v2_line_event m_raw[GPIO_EVENT_BATCH]; // kernel event buffer
+    gpio_event m_evt[GPIO_EVENT_BATCH]; // filtered event buffer
+    uint32_t m_evt_pos; // read position in event buffer
+    uint32_t m_evt_cnt; // count of events in event buffer
+};
+
+/**
+ * @brief class c_lines
+ *
+ * multiple gpio pins in one line request,
+ * one ioctl reads or writes all pins, bit n is n-th pin of init
+ */
+class c_lines
+{
+public:
+    /**
+     * @brief class constuctor
+     * @note call setchip()
+     */
+    c_lines()
+    {
+        m_fd = -1;
+        m_count = 0;
+        m_print_msg = false;
+        m_chip = NULL;
+    }
+
+    /**
+     * @brief class constuctor
+     * @param chip pointer to chip
+     * @param print_msg flag for print error messages, true = on
+     */
+    c_lines(c_chip* chip, bool print_msg = false)
+    {
+        m_fd = -1;
+        m_count = 0;
+        setchip(chip, print_msg);
+    }
+
+    /**
+     * @brief class destructor
+     */
+    ~c_lines()
     {
-        // set edge parameter
-        switch(edge)
+        deinit();
+    }
+
+    /**
+     * @brief set chip and message flag
+     * @param chip pointer to chip
+     * @param print_msg flag for print error messages, true = on
+     */
+    void setchip(c_chip* chip, bool print_msg = false)
+    {
+        m_print_msg = print_msg;
+        m_chip = chip;
+    }
+
+    /**
+     * @brief deinits gpio pins
+     */
+    void deinit()
+    {
+        // close line handle if open
+        if (m_fd != -1)
+            close(m_fd);
+        m_fd = -1;
+        m_count = 0;
+    }
+
+    /**
+     * @brief returns count of pins, 0 if not init
+     */
+    uint32_t get_count() { return m_count; }
+
+    /**
+     * @brief returns bit mask of all pins
+     */
+    inline uint64_t get_mask()
+    {
+        return (m_count >= 64) ? ~0ULL : ((1ULL << m_count) - 1);
+    }
+
+    /**
+     * @brief returns gpio pin number of line
+     * @param idx line index
+     * @returns 0..27, -1 if not init or invalid index
+     */
+    int32_t get_pin(uint32_t idx)
+    {
+        return (idx < m_count) ? m_pins[idx] : -1;
+    }
+
+    /**
+     * @brief returns line handle
+     * @returns handle, -1 if not init
+     */
+    inline int32_t get_fd() { return m_fd; }
+
+    /**
+     * @brief clears message buffer
+     */
+    void clear_error()
+    {
+        m_msg.erase();
+    }
+
+    /**
+     * @brief returns error message
+     * @returns message
+     */
+    const char* get_error()
+    {
+        return m_msg.c_str();
+    }
+
+    /**
+     * @brief stores message and prints error message if enabled on stderr
+     * @param msg message to print, if NULL errno is print
+     * @returns always false
+     */
+    bool print_error(const char* msg = NULL)
+    {
+        if (msg == NULL)
         {
-        case GPIO_EDGE_RISING:
-            line_config.flags += GPIO_V2_LINE_FLAG_EDGE_RISING;
-            break;
-        case GPIO_EDGE_FALLING:
-            line_config.flags += GPIO_V2_LINE_FLAG_EDGE_FALLING;
-            break;
-        case GPIO_EDGE_BOTH:
-            line_config.flags += GPIO_V2_LINE_FLAG_EDGE_RISING + GPIO_V2_LINE_FLAG_EDGE_FALLING;
-            break;
-        default:
-        case GPIO_EDGE_NONE:
-            break;
+            m_msg = "gpiox: ";
+            m_msg += strerror(errno);
         }
+        else
+            m_msg = msg;
+
+        // if flag set print error on console
+        if (m_print_msg)
+            puts(get_error());
+
+        return false;
+    }
+
+    /**
+     * @brief inits gpio pins with same mode
+     * @param pins gpio pins 0..27
+     * @param count count of pins 1..64
+     * @param mode gpio mode GPIO_MODE_..
+     * @param setval output: bit n is state of n-th pin
+     * @returns true: ok, false: error
+     */
+    bool init(const uint32_t* pins, uint32_t count, uint32_t mode, uint64_t setval = 0)
+    {
+        uint32_t modes[GPIO_V2_LINES_MAX];
+
+        for (uint32_t i = 0; (i < count) && (i < GPIO_V2_LINES_MAX); i++)
+            modes[i] = mode;
+
+        return init(pins, modes, count, setval);
+    }
+
+    /**
+     * @brief inits gpio pins, each pin with own mode
+     * @param pins gpio pins 0..27
+     * @param modes gpio mode GPIO_MODE_.. of each pin
+     * @param count count of pins 1..64
+     * @param setval output: bit n is state of n-th pin
+     * @param edge input edge GPIO_EDGE_.. of pins in edge_mask
+     * @param edge_mask bit n selects n-th pin for edge events, output pins are ignored
+     * @returns true: ok, false: error
+     */
+    bool init(const uint32_t* pins, const uint32_t* modes, uint32_t count, uint64_t setval = 0,
+        uint32_t edge = GPIO_EDGE_NONE, uint64_t edge_mask = 0)
+    {
+        // clear error
+        clear_error();
+
+        if ((pins == NULL) || (modes == NULL) || (count == 0) || (count > GPIO_V2_LINES_MAX))
+            return print_error("gpiox: invalid parameter");
+
+        // valid chip ?
+        if (m_chip == NULL)
+            return print_error("gpiox: invalid chip");
+
+        if (m_chip->get_fd() == -1)
+            return print_error("gpiox: chip not open");
+
+        // close lines
+        deinit();
+
+        gpio_v2_line_request line_request;
+
+        memset(&line_request, 0, sizeof(line_request));
+
+        line_request.num_lines = count;
+
+        uint64_t output = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (pins[i] >= N_PIN)
+                return print_error("gpiox: invalid pin");
+
+            uint64_t flags = gpio_mode_flags(modes[i]);
+
+            if (flags == 0)
+                return print_error("gpiox: invalid mode");
+
+            if (flags & GPIO_V2_LINE_FLAG_OUTPUT)
+                output |= 1ULL << i;
+            else if (edge_mask & (1ULL << i))
+                flags |= gpio_edge_flags(edge);
+
+            line_request.offsets[i] = pins[i];
+
+            // first pin sets default flags
+            if (i == 0)
+            {
+                line_request.config.flags = flags;
+                continue;
+            }
+
+            if (flags == line_request.config.flags)
+                continue;
+
+            // pins with other flags get flags attribute
+            if (!add_attr(line_request.config, GPIO_V2_LINE_ATTR_ID_FLAGS, flags, 1ULL << i))
+                return print_error("gpiox: too many modes");
+        }
+
+        // set output states, needs one attribute left after flags
+        if (output != 0)
+            if (!add_attr(line_request.config, GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES, setval, output))
+                return print_error("gpiox: too many modes");
+
+        // init gpio pins
+        if (ioctl(m_chip->get_fd(), GPIO_V2_GET_LINE_IOCTL, &line_request) == -1)
+            return print_error();
+
+        // check for valid handle
+        if (line_request.fd < 0)
+            return print_error();
+
+        m_fd = line_request.fd;
+        m_count = count;
+
+        for (uint32_t i = 0; i < count; i++)
+            m_pins[i] = pins[i];
+
+        return true;
+    }
+
+    /**
+     * @brief writes pins with one ioctl
+     * @param bits bit n is state of n-th pin
+     * @param mask bit n selects n-th pin
+     * @returns false: error, true: ok
+     * @note no lock, for time critical drivers
+     */
+    inline bool write(uint64_t bits, uint64_t mask)
+    {
+        gpio_v2_line_values line_values = { bits, mask };
+
+        if (ioctl(m_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &line_values) == -1)
+            return print_error();
+
+        return true;
+    }
+
+    /**
+     * @brief reads pins with one ioctl
+     * @param bits receives states, bit n is state of n-th pin
+     * @param mask bit n selects n-th pin
+     * @returns false: error, true: ok
+     * @note no lock, for time critical drivers
+     */
+    inline bool read(uint64_t& bits, uint64_t mask)
+    {
+        gpio_v2_line_values line_values = { 0, mask };
+
+        if (ioctl(m_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &line_values) == -1)
+        {
+            bits = 0;
+            return print_error();
+        }
+
+        bits = line_values.bits & mask;
+
+        return true;
+    }
+
+    /**
+     * @brief waits for edge events of pins
+     * @param events receives events, pin is gpio pin
+     * @param size max. count of events
+     * @param timeout_ms timeout in ms, -1: wait forever, 0: no wait
+     * @returns count of events, 0: timeout, -1: error
+     * @note no lock, no userspace filter, pins need edge on init
+     */
+    int32_t watch(gpio_event* events, uint32_t size, int32_t timeout_ms = -1)
+    {
+        if ((events == NULL) || (size == 0))
+        {
+            print_error("gpiox: invalid parameter");
+            return -1;
+        }
+
+        pollfd pfd = { .fd = m_fd, .events = POLLIN, .revents = 0 };
+
+        int32_t ret = poll(&pfd, 1, timeout_ms);
+
+        if (ret < 0)
+        {
+            // signal is timeout
+            if (errno == EINTR)
+                return 0;
+
+            print_error();
+            return -1;
+        }
+
+        if (ret == 0)
+            return 0;
+
+        gpio_v2_line_event raw[GPIO_EVENT_BATCH];
+
+        if (size > GPIO_EVENT_BATCH)
+            size = GPIO_EVENT_BATCH;
+
+        ssize_t len = ::read(m_fd, raw, size * sizeof(gpio_v2_line_event));
+
+        if (len == -1)
+        {
+            if (errno == EAGAIN)
+                return 0;
+
+            print_error();
+            return -1;
+        }
+
+        if ((len == 0) || (len % sizeof(gpio_v2_line_event) != 0))
+        {
+            print_error("gpiox: invalid event data");
+            return -1;
+        }
+
+        uint32_t n = len / sizeof(gpio_v2_line_event);
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            events[i].timestamp_ns = raw[i].timestamp_ns;
+            events[i].pin = raw[i].offset;
+            events[i].edge = (raw[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE) ? GPIO_EDGE_RISING : GPIO_EDGE_FALLING;
+        }
+
+        return n;
+    }
+
+private:
+    // adds attribute to line config, flags attribute merges pins with same flags
+    bool add_attr(gpio_v2_line_config& line_config, uint32_t id, uint64_t value, uint64_t mask)
+    {
+        for (uint32_t i = 0; i < line_config.num_attrs; i++)
+        {
+            gpio_v2_line_config_attribute& a = line_config.attrs[i];
+
+            if ((id == GPIO_V2_LINE_ATTR_ID_FLAGS) && (a.attr.id == id) && (a.attr.flags == value))
+            {
+                a.mask |= mask;
+                return true;
+            }
+        }
+
+        if (line_config.num_attrs >= GPIO_V2_LINE_NUM_ATTRS_MAX)
+            return false;
+
+        gpio_v2_line_config_attribute& a = line_config.attrs[line_config.num_attrs++];
+
+        a.attr.id = id;
+        a.mask = mask;
+
+        if (id == GPIO_V2_LINE_ATTR_ID_FLAGS)
+            a.attr.flags = value;
+        else
+            a.attr.values = value;
+
+        return true;
     }
 
     c_chip* m_chip;   // chip
-    int32_t m_pin;    // gpio pin
-    int32_t m_fd;     // gpio pin handle
+    int32_t m_fd;     // line handle
+    uint32_t m_count; // count of pins
+    uint32_t m_pins[GPIO_V2_LINES_MAX]; // gpio pins
     bool m_print_msg; // flag for print message
     string m_msg;     // store for messages
-    mutex m_mtx;      // lock mutex
 };